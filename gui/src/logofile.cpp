@@ -1,6 +1,7 @@
 #include "logofile.h"
 #include "thumbnailprovider.h"
 #include "appcontext.h"
+#include "../../include/pixel_convert.h"
 #include <QFileInfo>
 #include <QFile>
 #include <QDir>
@@ -53,8 +54,8 @@ bool LogoFile::loadMtkFile(const QString &path) {
     QFileInfo fileInfo(path);
     
     try {
-        // Load the logo image
-        LogoImage logoImage = LogoImage::readFromFile(path.toStdString());
+        // Map the logo image, each blob is copied out of the mapping once
+        LogoImageView logoImage = LogoImageView::open(path.toStdString());
         
         if (logoImage.getLogoCount() == 0) {
             emit errorOccurred("No logos found in file");
@@ -62,8 +63,10 @@ bool LogoFile::loadMtkFile(const QString &path) {
         }
         
         m_logoImages.clear();
-        for (size_t i = 0; i < logoImage.blobs.size(); ++i) {
-            m_logoImages.push_back(logoImage.blobs[i]);
+        m_logoImages.reserve(logoImage.getLogoCount());
+        for (size_t i = 0; i < logoImage.getLogoCount(); ++i) {
+            bootmod::ByteSpan blob = logoImage.blob(i);
+            m_logoImages.push_back(std::vector<uint8_t>(blob.begin(), blob.end()));
         }
         
         // Extract header info
@@ -71,6 +74,11 @@ bool LogoFile::loadMtkFile(const QString &path) {
             .arg(logoImage.table.logo_count)
             .arg(logoImage.table.block_size);
         
+        // Slots are sized with a discard-only inflate, thumbnails are then
+        // inflated a row at a time straight into the QImage
+        CodecContext& codec = CodecContext::forThread();
+        std::vector<uint8_t>& row = codec.scratch();
+        
         // Create entries with placeholder data
         for (size_t i = 0; i < m_logoImages.size(); ++i) {
             LogoEntry entry;
@@ -78,19 +86,19 @@ bool LogoFile::loadMtkFile(const QString &path) {
             entry.size = m_logoImages[i].size();
             entry.format = "Compressed";
             
-            // Decompress to get dimensions
+            // Probe decompressed size to get dimensions
             try {
-                auto decompressed = ImageUtils::zlibDecompress(m_logoImages[i]);
+                size_t decompressed_size = ImageUtils::inflatedSize(m_logoImages[i]);
                 
                 // Guess dimensions - try BGRA first
-                auto dims = MtkLogo::guessDimensions(decompressed.size(), ColorMode::BGRA_LE);
+                auto dims = MtkLogo::guessDimensions(decompressed_size, ColorMode::BGRA_BE);
                 if (!dims.empty()) {
                     entry.width = dims[0].first;
                     entry.height = dims[0].second;
                     entry.format = "BGRA";
                 } else {
                     // Try RGB565
-                    dims = MtkLogo::guessDimensions(decompressed.size(), ColorMode::RGB565_LE);
+                    dims = MtkLogo::guessDimensions(decompressed_size, ColorMode::RGB565_LE);
                     if (!dims.empty()) {
                         entry.width = dims[0].first;
                         entry.height = dims[0].second;
@@ -103,34 +111,20 @@ bool LogoFile::loadMtkFile(const QString &path) {
                 
                 // Create QImage for thumbnail
                 if (entry.width > 0 && entry.height > 0) {
-                    QImage image;
-                    if (entry.format == "BGRA") {
-                        image = QImage(entry.width, entry.height, QImage::Format_RGBA8888);
-                        const uint8_t* src = decompressed.data();
-                        
-                        for (int y = 0; y < entry.height; ++y) {
-                            uint8_t* dst = image.scanLine(y);
-                            for (int x = 0; x < entry.width; ++x) {
-                                // BGRA to RGBA
-                                dst[x*4 + 0] = src[x*4 + 2]; // R
-                                dst[x*4 + 1] = src[x*4 + 1]; // G
-                                dst[x*4 + 2] = src[x*4 + 0]; // B
-                                dst[x*4 + 3] = src[x*4 + 3]; // A
-                            }
-                            src += entry.width * 4;
+                    QImage image(entry.width, entry.height, QImage::Format_RGBA8888);
+                    bool bgra = entry.format == "BGRA";
+                    row.resize(static_cast<size_t>(entry.width) * (bgra ? 4 : 2));
+                    
+                    // BGRA to RGBA or RGB565 to RGBA, one row at a time (scanlines may be padded)
+                    bootmod::InflateScope stream(codec, m_logoImages[i]);
+                    for (int y = 0; y < entry.height; ++y) {
+                        if (stream.read(row.data(), row.size()) != row.size()) {
+                            throw std::runtime_error("Truncated logo data");
                         }
-                    } else if (entry.format == "RGB565") {
-                        image = QImage(entry.width, entry.height, QImage::Format_RGB888);
-                        const uint16_t* src = reinterpret_cast<const uint16_t*>(decompressed.data());
-                        
-                        for (int y = 0; y < entry.height; ++y) {
-                            uint8_t* dst = image.scanLine(y);
-                            for (int x = 0; x < entry.width; ++x) {
-                                uint16_t pixel = src[y * entry.width + x];
-                                dst[x*3 + 0] = ((pixel >> 11) & 0x1F) << 3; // R
-                                dst[x*3 + 1] = ((pixel >> 5) & 0x3F) << 2;  // G
-                                dst[x*3 + 2] = (pixel & 0x1F) << 3;          // B
-                            }
+                        if (bgra) {
+                            bootmod::pixel::swapRedBlue(row.data(), image.scanLine(y), entry.width);
+                        } else {
+                            bootmod::pixel::rgb565ToRgba(row.data(), image.scanLine(y), entry.width, false);
                         }
                     }
                     
@@ -197,20 +191,24 @@ bool LogoFile::loadSplashFile(const QString &path) {
         for (uint32_t i = 0; i < imageCount; ++i) {
             auto info = m_splashImage->getImageInfo(i);
             
+            // Geometry comes from a 54-byte header peek, cached by SplashImage
             LogoEntry entry;
             entry.index = i + 1;
             entry.width = info.width;
             entry.height = info.height;
             entry.size = info.compressed_size;
-            entry.format = "BMP+gzip";
+            entry.format = info.bpp ? QString("BMP%1+gzip").arg(info.bpp) : QString("BMP+gzip");
             
-            // Get decompressed image data for thumbnail
+            // Only the thumbnail needs pixels, skip depths it cannot draw
             uint32_t width, height;
-            auto bmpData = m_splashImage->getImageData(i, width, height);
+            std::vector<uint8_t> bmpData;
+            if (info.bpp == 24 || info.bpp == 32) {
+                bmpData = m_splashImage->getImageData(i, width, height);
+            }
             
             if (!bmpData.empty() && bmpData.size() >= 54) {
                 // Parse BMP to create thumbnail
-                uint16_t bpp = *reinterpret_cast<uint16_t*>(&bmpData[28]);
+                uint16_t bpp = info.bpp;
                 uint32_t offset = *reinterpret_cast<uint32_t*>(&bmpData[10]);
                 
                 QImage image(width, height, QImage::Format_RGBA8888);
@@ -272,6 +270,7 @@ void LogoFile::clearFile() {
     m_logos.clear();
     m_logoImages.clear();
     m_splashImage.reset();
+    m_manifest.reset();
     m_filePath.clear();
     m_projectDir.clear();
     m_headerInfo.clear();
@@ -320,26 +319,18 @@ bool LogoFile::extractLogo(int index, const QString &outputPath) {
                 return false;
             }
             
-            // Decompress
-            auto decompressed = ImageUtils::zlibDecompress(m_logoImages[index - 1]);
-            
             // Get dimensions from our stored entry
             const LogoEntry& entry = m_logos[index - 1];
             
             // Determine color mode
-            ColorMode mode = (entry.format == "RGB565") ? ColorMode::RGB565_LE : ColorMode::BGRA_LE;
-            
-            // Save as PNG
-            bool success = ImageUtils::saveToPNG(outputPath.toStdString(), decompressed, 
-                                                 entry.width, entry.height, mode);
+            ColorMode mode = (entry.format == "RGB565") ? ColorMode::RGB565_LE : ColorMode::BGRA_BE;
             
-            if (success) {
-                emit operationCompleted(QString("Exported logo #%1 to %2").arg(index).arg(outputPath));
-            } else {
-                emit errorOccurred("Failed to save PNG");
-            }
+            // Inflate band by band straight into the PNG, the frame is never held whole
+            ImageUtils::inflateToPNG(m_logoImages[index - 1], outputPath.toStdString(),
+                                     entry.width, entry.height, mode);
             
-            return success;
+            emit operationCompleted(QString("Exported logo #%1 to %2").arg(index).arg(outputPath));
+            return true;
         }
         
     } catch (const std::exception& e) {
@@ -459,7 +450,7 @@ bool LogoFile::replaceLogo(int index, const QString &imagePath) {
             qDebug() << "Replacing MTK logo...";
             uint32_t width, height;
             const LogoEntry& entry = m_logos[index - 1];
-            ColorMode mode = (entry.format == "RGB565") ? ColorMode::RGB565_LE : ColorMode::BGRA_LE;
+            ColorMode mode = (entry.format == "RGB565") ? ColorMode::RGB565_LE : ColorMode::BGRA_BE;
             
             auto pixels = ImageUtils::loadFromPNG(imagePath.toStdString(), width, height, mode);
             
@@ -576,9 +567,12 @@ bool LogoFile::saveFile(const QString &outputPath) {
             return true;
             
         } else if (m_currentFormat == bootmod::FormatType::MTK_LOGO) {
-            // Save MediaTek logo.bin
-            LogoImage image = LogoImage::createFromBlobs(m_logoImages);
-            image.writeToFile(outputPath.toStdString());
+            // Save MediaTek logo.bin, streaming blobs straight to disk
+            LogoImageWriter writer(outputPath.toStdString(), m_logoImages.size());
+            for (const auto& blob : m_logoImages) {
+                writer.append(blob);
+            }
+            writer.finish();
             
             emit operationCompleted(QString("Saved logo.bin to %1").arg(outputPath));
             return true;
@@ -740,15 +734,25 @@ bool LogoFile::unpackToProject(const QString &logoPath, const QString &projectDi
     
     // Extract all logos/images based on format
     if (m_currentFormat == bootmod::FormatType::OPPO_SPLASH) {
-        // Snapdragon format: use image_N.png naming
-        for (const auto& logo : m_logos) {
-            QString filename = QString("image_%1.png").arg(logo.index - 1); // 0-based for splash
-            QString outputPath = imagesDir + "/" + filename;
-            
-            if (!extractLogo(logo.index, outputPath)) {
-                emit errorOccurred(QString("Failed to extract image #%1").arg(logo.index));
-                return false;
-            }
+        // Snapdragon format: use image_N.png naming, all images extract concurrently
+        if (!m_splashImage) {
+            emit errorOccurred("Splash image not loaded");
+            return false;
+        }
+        
+        std::string imagesPath = imagesDir.toStdString();
+        int failed = 0;
+        bool extracted = m_splashImage->extractAll(
+            [&](uint32_t i) { return imagesPath + "/image_" + std::to_string(i) + ".png"; },
+            0,
+            [&](uint32_t i, bool ok) {
+                if (!ok) {
+                    failed = static_cast<int>(i) + 1;
+                }
+            });
+        if (!extracted) {
+            emit errorOccurred(QString("Failed to extract image #%1").arg(failed));
+            return false;
         }
     } else {
         // MediaTek format: use logo_N_WxH.png naming
@@ -764,6 +768,24 @@ bool LogoFile::unpackToProject(const QString &logoPath, const QString &projectDi
                 return false;
             }
         }
+        
+        // Record what was extracted so unchanged logos keep their original blob
+        try {
+            ProjectManifest manifest;
+            for (const auto& logo : m_logos) {
+                QString filename = QString("logo_%1_%2x%3.png")
+                    .arg(logo.index)
+                    .arg(logo.width)
+                    .arg(logo.height);
+                ColorMode mode = (logo.format == "RGB565") ? ColorMode::RGB565_LE : ColorMode::BGRA_BE;
+                manifest.add(imagesDir.toStdString(), logo.index, mode, filename.toStdString());
+            }
+            manifest.save(imagesDir.toStdString(), logoPath.toStdString());
+        } catch (const std::exception& e) {
+            emit errorOccurred(QString("Failed to write project manifest: %1").arg(e.what()));
+            return false;
+        }
+        loadProjectManifest(imagesDir);
     }
     
     // Create project identifier and metadata
@@ -943,6 +965,9 @@ bool LogoFile::openProject(const QString &projectDir) {
             return a < b;
         });
         
+        // Unchanged images reuse their original blob from the unpack manifest
+        loadProjectManifest(imagesDir);
+        
         // Load each image and create blobs
         for (const QString& filename : imageFiles) {
             QString imagePath = imagesDir + "/" + filename;
@@ -953,20 +978,18 @@ bool LogoFile::openProject(const QString &projectDir) {
                 continue;
             }
             
-            // Load PNG and convert to raw BGRA, then compress
             try {
-                uint32_t width = 0, height = 0;
-                auto rawPixels = ImageUtils::loadFromPNG(imagePath.toStdString(), width, height, ColorMode::BGRA_LE);
-                auto compressedBlob = ImageUtils::zlibCompress(rawPixels);
+                QString format;
+                auto compressedBlob = projectImageBlob(imagePath, format);
                 
                 m_logoImages.push_back(compressedBlob);
                 
                 // Create entry
                 LogoEntry entry;
                 entry.index = m_logos.size() + 1;
-                entry.width = width;
-                entry.height = height;
-                entry.format = "BGRA8888";
+                entry.width = image.width();
+                entry.height = image.height();
+                entry.format = format;
                 entry.size = compressedBlob.size();
                 entry.thumbnail = createThumbnail(image);
                 entry.rawData = compressedBlob;
@@ -1048,17 +1071,16 @@ void LogoFile::rescanProjectImages() {
             }
             
             try {
-                uint32_t width = 0, height = 0;
-                auto rawPixels = ImageUtils::loadFromPNG(imagePath.toStdString(), width, height, ColorMode::BGRA_LE);
-                auto compressedBlob = ImageUtils::zlibCompress(rawPixels);
+                QString format;
+                auto compressedBlob = projectImageBlob(imagePath, format);
                 
                 m_logoImages.push_back(compressedBlob);
                 
                 LogoEntry entry;
                 entry.index = m_logos.size() + 1;
-                entry.width = width;
-                entry.height = height;
-                entry.format = "BGRA8888";
+                entry.width = image.width();
+                entry.height = image.height();
+                entry.format = format;
                 entry.size = compressedBlob.size();
                 entry.thumbnail = createThumbnail(image);
                 entry.rawData = compressedBlob;
@@ -1115,15 +1137,15 @@ void LogoFile::refreshSingleLogo(int index) {
         }
         
         try {
-            uint32_t width = 0, height = 0;
-            auto rawPixels = ImageUtils::loadFromPNG(imagePath.toStdString(), width, height, ColorMode::BGRA_LE);
-            auto compressedBlob = ImageUtils::zlibCompress(rawPixels);
+            QString format;
+            auto compressedBlob = projectImageBlob(imagePath, format);
             
             // Update the existing logo entry
             int logoIdx = index - 1;  // Convert to 0-based index
             if (logoIdx >= 0 && logoIdx < m_logos.size()) {
-                m_logos[logoIdx].width = width;
-                m_logos[logoIdx].height = height;
+                m_logos[logoIdx].width = image.width();
+                m_logos[logoIdx].height = image.height();
+                m_logos[logoIdx].format = format;
                 m_logos[logoIdx].size = compressedBlob.size();
                 m_logos[logoIdx].thumbnail = createThumbnail(image);
                 m_logos[logoIdx].rawData = compressedBlob;
@@ -1242,6 +1264,37 @@ bool LogoFile::createProjectIdentifier(const QString &projectDir) {
     return true;
 }
 
+void LogoFile::loadProjectManifest(const QString &imagesDir) {
+    m_manifest.reset(new ProjectManifest());
+    
+    try {
+        if (!m_manifest->load(imagesDir.toStdString())) {
+            m_manifest.reset();  // Older project, every image gets compressed
+        }
+    } catch (const std::exception& e) {
+        qWarning() << "Ignoring project manifest:" << e.what();
+        m_manifest.reset();
+    }
+}
+
+std::vector<uint8_t> LogoFile::projectImageBlob(const QString &imagePath, QString &format) {
+    // Images not edited since unpack keep their original compressed blob
+    if (m_manifest) {
+        const ManifestEntry* unchanged = m_manifest->findUnchanged(imagePath.toStdString());
+        if (unchanged) {
+            bootmod::ByteSpan blob = m_manifest->originalBlob(*unchanged);
+            format = (unchanged->mode == ColorMode::RGB565_LE) ? "RGB565" : "BGRA8888";
+            return std::vector<uint8_t>(blob.begin(), blob.end());
+        }
+    }
+    
+    // Load PNG and convert to raw BGRA, then compress
+    uint32_t width = 0, height = 0;
+    auto rawPixels = ImageUtils::loadFromPNG(imagePath.toStdString(), width, height, ColorMode::BGRA_BE);
+    format = "BGRA8888";
+    return ImageUtils::zlibCompress(rawPixels);
+}
+
 bool LogoFile::loadProjectMetadata(const QString &projectDir) {
     QString identifierPath = projectDir + "/.bootmod";
     QFile file(identifierPath);
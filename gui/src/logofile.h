@@ -7,6 +7,7 @@
 #include <QImage>
 #include "../../include/bootmod.h"
 #include "../../include/splash.h"
+#include "../../include/project.h"
 
 class ThumbnailProvider;
 
@@ -95,6 +96,7 @@ private:
     
     // Format-specific storage
     std::unique_ptr<bootmod::splash::SplashImage> m_splashImage;
+    std::unique_ptr<mtklogo::ProjectManifest> m_manifest;  // MTK project unpack manifest, if any
     
     ThumbnailProvider* m_thumbnailProvider = nullptr;
     
@@ -106,6 +108,8 @@ private:
     bool loadSplashFile(const QString &path);
     bool createProjectIdentifier(const QString &projectDir);
     bool loadProjectMetadata(const QString &projectDir);
+    void loadProjectManifest(const QString &imagesDir);
+    std::vector<uint8_t> projectImageBlob(const QString &imagePath, QString &format);
 };
 
 #endif // LOGOFILE_H
@@ -6,9 +6,15 @@
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <fstream>
+#include "mapped_file.h"
+#include "codec.h"
 
 namespace bootmod {
 
+class ThreadPool;
+struct SlotStats;
+
 // Boot image format enumeration
 enum class FormatType {
     UNKNOWN,
@@ -19,6 +25,9 @@ enum class FormatType {
 // Format detection utility
 FormatType detectFormat(const std::string& filename);
 
+// printf-style append to a string, no length limit
+void appendFormat(std::string& out, const char* format, ...);
+
 } // namespace bootmod
 
 namespace mtklogo {
@@ -30,11 +39,13 @@ enum class Endian {
 };
 
 // Color mode enumeration
+// 32-bit modes name the channels of a pixel word, _BE stores them in that
+// order and _LE reversed. RGB565 modes set the byte order of the 16-bit word.
 enum class ColorMode {
-    RGBA_BE,    // RGBA Big Endian
-    RGBA_LE,    // RGBA Little Endian
-    BGRA_BE,    // BGRA Big Endian
-    BGRA_LE,    // BGRA Little Endian
+    RGBA_BE,    // RGBA Big Endian (bytes R G B A)
+    RGBA_LE,    // RGBA Little Endian (bytes A B G R)
+    BGRA_BE,    // BGRA Big Endian (bytes B G R A)
+    BGRA_LE,    // BGRA Little Endian (bytes A R G B)
     RGB565_BE,  // RGB565 Big Endian
     RGB565_LE   // RGB565 Little Endian
 };
@@ -108,15 +119,94 @@ public:
     size_t getLogoCount() const { return blobs.size(); }
 };
 
+// Read-only logo image backed by a memory-mapped file.
+// Blobs are views into the mapping, nothing is copied.
+class LogoImageView {
+public:
+    LogoTable table;
+
+    // Map file and parse its logo table
+    static LogoImageView open(const std::string& filename);
+    
+    // Get compressed data of one logo (valid while the view is alive)
+    bootmod::ByteSpan blob(size_t index) const;
+    
+    // Get number of logos
+    size_t getLogoCount() const { return blobs_.size(); }
+    
+    // Copy all blobs into an owning LogoImage
+    LogoImage toLogoImage() const;
+
+private:
+    bootmod::MappedFile file_;
+    std::vector<bootmod::ByteSpan> blobs_;
+};
+
+// Streaming logo image writer.
+// Header and table go out first with placeholder offsets, blobs are
+// appended as they are produced and the table is patched in finish(),
+// so the complete image never has to be held in memory. Everything goes
+// to <filename>.tmp, which finish() renames over filename; a writer
+// destroyed before that removes it and leaves any existing file alone.
+class LogoImageWriter {
+public:
+    LogoImageWriter(const std::string& filename, size_t logo_count);
+    ~LogoImageWriter();
+    
+    // Append next blob
+    void append(const uint8_t* data, size_t size);
+    void append(const std::vector<uint8_t>& blob) { append(blob.data(), blob.size()); }
+    
+    // Patch offsets and sizes, close the file and move it into place
+    void finish();
+    
+    // Table as written so far
+    const LogoTable& getTable() const { return table_; }
+    
+    // Total file size so far
+    size_t getTotalSize() const { return MtkHeader::SIZE + table_.block_size; }
+
+private:
+    std::string filename_;
+    std::string temp_filename_;
+    std::ofstream file_;
+    LogoTable table_;
+    size_t expected_count_;
+    bool finished_;
+};
+
+// Codec state lives in codec.h and is shared with the splash code
+using bootmod::CodecContext;
+
 // Image processing utilities
 class ImageUtils {
 public:
     // Decompress zlib data
     static std::vector<uint8_t> zlibDecompress(const std::vector<uint8_t>& compressed);
+    static std::vector<uint8_t> zlibDecompress(const uint8_t* data, size_t size);
     
     // Compress data with zlib
     static std::vector<uint8_t> zlibCompress(const std::vector<uint8_t>& data, int level = 9);
     
+    // Decompress into a pre-sized buffer (e.g. width * height * bpp), returns bytes written
+    static size_t decompressInto(bootmod::ByteSpan compressed, uint8_t* dst, size_t capacity);
+    
+    // Decompressed size of a zlib blob without holding its output.
+    // Throws if the blob is corrupt.
+    static size_t inflatedSize(bootmod::ByteSpan compressed);
+    
+    // Decompress only the first count bytes (e.g. to sniff a header), returns bytes written
+    static size_t peekInflated(bootmod::ByteSpan compressed, uint8_t* dst, size_t count);
+    
+    // Compress into a buffer of at least compressBound() bytes, returns bytes written
+    static size_t compressInto(bootmod::ByteSpan data, uint8_t* dst, size_t capacity, int level = 9);
+    
+    // 64-bit content hash for change and duplicate detection (checksum::hash64)
+    static uint64_t hashBytes(bootmod::ByteSpan data);
+    
+    // Worst-case compressed size
+    static size_t compressBound(size_t size) { return CodecContext::forThread().deflateBound(size); }
+    
     // Convert raw pixel data to PNG
     static bool saveToPNG(const std::string& filename, 
                          const std::vector<uint8_t>& pixels,
@@ -124,17 +214,49 @@ public:
                          uint32_t height,
                          ColorMode mode);
     
+    // Decompressed size of a zlib blob, to pick its dimensions before
+    // inflateToPNG(). Streaming backends (zlib) measure with an output-free
+    // pass and inflateToPNG() decodes again band by band, so no frame is
+    // ever held. One-shot backends (lodepng, libdeflate) hold the whole
+    // frame on every inflate anyway, so they decode it once into frame and
+    // inflateToPNG() encodes from there. Throws if the blob is corrupt.
+    static size_t measureFrame(bootmod::ByteSpan blob, std::vector<uint8_t>& frame);
+    
+    // Inflate a zlib blob straight into a PNG, one band of rows at a time.
+    // A non-empty frame from measureFrame() is encoded instead of inflating
+    // the blob again. Throws if the blob is corrupt or does not hold exactly
+    // width x height pixels.
+    static void inflateToPNG(bootmod::ByteSpan blob,
+                             const std::string& filename,
+                             uint32_t width,
+                             uint32_t height,
+                             ColorMode mode,
+                             const std::vector<uint8_t>& frame = std::vector<uint8_t>());
+    
+    // Same, encoding the PNG into memory
+    static void inflateToPNG(bootmod::ByteSpan blob,
+                             std::vector<uint8_t>& png,
+                             uint32_t width,
+                             uint32_t height,
+                             ColorMode mode,
+                             const std::vector<uint8_t>& frame = std::vector<uint8_t>());
+    
     // Load PNG and convert to raw pixels
     static std::vector<uint8_t> loadFromPNG(const std::string& filename,
                                            uint32_t& width,
                                            uint32_t& height,
                                            ColorMode mode);
     
-    // Convert between color modes
+    // Convert between any two color modes
     static std::vector<uint8_t> convertColorMode(const std::vector<uint8_t>& pixels,
                                                  ColorMode from,
                                                  ColorMode to);
     
+    // Convert in the same buffer, resized to the target format
+    static void convertColorModeInPlace(std::vector<uint8_t>& pixels,
+                                        ColorMode from,
+                                        ColorMode to);
+    
     // Get bytes per pixel for color mode
     static uint32_t getBytesPerPixel(ColorMode mode);
     
@@ -145,6 +267,76 @@ public:
     static ColorMode parseColorMode(const std::string& name);
 };
 
+// Reads a PNG in bands of rows converted to a color mode, so a frame can
+// be hashed or compressed without holding it in memory. Interlaced images
+// are decoded whole first since their rows only complete on the last pass.
+class PngRowReader {
+public:
+    PngRowReader(const std::string& filename, ColorMode mode);
+    ~PngRowReader();
+    
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    
+    // Size of the whole frame in the target mode
+    size_t frameSize() const { return static_cast<size_t>(row_bytes_) * height_; }
+    
+    // Next band of rows, empty once every row has been read.
+    // The span stays valid until the next call.
+    bootmod::ByteSpan readBand();
+
+private:
+    PngRowReader(const PngRowReader&);
+    PngRowReader& operator=(const PngRowReader&);
+    
+    struct State;
+    std::unique_ptr<State> state_;
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t row_bytes_;
+    uint32_t band_rows_;
+    uint32_t next_row_;
+};
+
+// Writes a PNG from bands of rows in any color mode. Each band is
+// converted to RGBA in place and handed to libpng before the next one is
+// filled. A file that is never finished is removed.
+class PngRowWriter {
+public:
+    PngRowWriter(const std::string& filename, uint32_t width, uint32_t height, ColorMode mode);
+    // Encode into out instead of a file, out holds the PNG after finish()
+    PngRowWriter(std::vector<uint8_t>& out, uint32_t width, uint32_t height, ColorMode mode);
+    ~PngRowWriter();
+    
+    // Rows per band and bytes per row in the source mode
+    uint32_t bandRows() const { return band_rows_; }
+    size_t rowBytes() const { return row_bytes_; }
+    
+    // Room for bandRows() rows in the source mode
+    uint8_t* bandBuffer();
+    
+    // Convert and write the first `rows` rows of the band buffer
+    void writeBand(uint32_t rows);
+    
+    // Complete the file, throws unless every row was written
+    void finish();
+
+private:
+    PngRowWriter(const PngRowWriter&);
+    PngRowWriter& operator=(const PngRowWriter&);
+    
+    // Set up libpng for io, the open file or the output vector
+    void start(ColorMode mode, void* io);
+    
+    struct State;
+    std::unique_ptr<State> state_;
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t row_bytes_;
+    uint32_t band_rows_;
+    uint32_t next_row_;
+};
+
 // File information structure
 struct FileInfo {
     size_t id;
@@ -158,23 +350,103 @@ struct FileInfo {
     static FileInfo fromFilename(const std::string& filename);
 };
 
+class DeviceProfile;
+
+// Unpack settings
+struct UnpackOptions {
+    ColorMode mode;
+    std::vector<size_t> slots;     // 1-based slots to extract, empty = all
+    bool extract_raw;              // Write .z blobs instead of PNGs
+    bool flip;
+    size_t jobs;                   // Worker threads, 0 = every CPU core
+    const DeviceProfile* profile;  // Takes precedence over guessDimensions() if set
+    bootmod::ThreadPool* pool;     // Run on this pool instead of starting one (jobs is ignored)
+    std::string* log;              // Collect progress and errors here instead of printing them
+    std::vector<bootmod::SlotStats>* stats;  // Per-slot sizes and timings in slot order, if set
+    
+    UnpackOptions() : mode(ColorMode::BGRA_BE), extract_raw(false), flip(false), jobs(0),
+                      profile(nullptr), pool(nullptr), log(nullptr), stats(nullptr) {}
+};
+
+// Repack settings
+struct RepackOptions {
+    bool strip_alpha;
+    size_t jobs;          // Worker threads, 0 = every CPU core
+    size_t target_size;   // Fit the image into this many bytes, 0 = always level 9
+    bool use_manifest;    // Copy original blobs of images unchanged since unpack
+    bootmod::ThreadPool* pool;  // Run on this pool instead of starting one (jobs is ignored)
+    std::string* log;           // Collect progress and errors here instead of printing them
+    std::vector<bootmod::SlotStats>* stats;  // Per-slot sizes and timings in slot order, if set
+    
+    RepackOptions() : strip_alpha(false), jobs(0), target_size(0), use_manifest(true),
+                      pool(nullptr), log(nullptr), stats(nullptr) {}
+};
+
+// Metadata of one logo slot, see MtkLogo::describe()
+struct LogoSlotInfo {
+    size_t offset;             // Blob offset from the start of the file
+    uint32_t size;             // Stored (compressed) size
+    bool zlib;                 // Blob starts with a zlib header
+    bool measured;             // Decompressed size was computed
+    bool corrupt;              // Inflate failed, decompressed_size is 0
+    size_t decompressed_size;
+    
+    LogoSlotInfo() : offset(0), size(0), zlib(false), measured(false), corrupt(false),
+                     decompressed_size(0) {}
+};
+
+// Result of MtkLogo::verify() for one slot
+struct LogoSlotCheck {
+    size_t offset;             // Blob offset from the start of the file
+    uint32_t size;             // Stored (compressed) size, 0 if the table entry is unusable
+    size_t decompressed_size;  // 0 unless the blob inflated
+    std::string error;         // Why the slot is broken, empty if it is sound
+    std::string warning;       // Usable but suspicious, e.g. no known resolution
+    
+    LogoSlotCheck() : offset(0), size(0), decompressed_size(0) {}
+};
+
 // Main operations
 class MtkLogo {
 public:
-    // Unpack logo.bin to directory
+    // Unpack logo.bin to directory (jobs = 0 uses every CPU core).
+    // A device profile, if given, takes precedence over guessDimensions().
     static bool unpack(const std::string& logo_file,
                       const std::string& output_dir,
                       ColorMode mode,
                       const std::vector<size_t>& slots = {},
                       bool extract_raw = false,
-                      bool flip = false);
+                      bool flip = false,
+                      size_t jobs = 0,
+                      const DeviceProfile* profile = nullptr);
+    static bool unpack(const std::string& logo_file,
+                      const std::string& output_dir,
+                      const UnpackOptions& options);
+    
+    // Slot metadata of a mapped image without decoding any pixels.
+    // With measure, zlib blobs are inflated into a discard window to get
+    // their decompressed size, spread over pool if given.
+    static std::vector<LogoSlotInfo> describe(const LogoImageView& image,
+                                              bool measure = true,
+                                              bootmod::ThreadPool* pool = nullptr);
+    
+    // Check every slot of a logo.bin without writing anything: table
+    // offsets increasing and inside the file, each blob a complete zlib
+    // stream (checksum included), and its size a resolution known to the
+    // profile (generic if null; only a warning). Slots inflate into a
+    // discard window, spread over pool if given. Throws if the header or
+    // table cannot be read at all.
+    static std::vector<LogoSlotCheck> verify(const std::string& logo_file,
+                                             const DeviceProfile* profile = nullptr,
+                                             bootmod::ThreadPool* pool = nullptr);
     
     // Repack images to logo.bin
     static bool repack(const std::vector<std::string>& input_files,
                       const std::string& output_file,
-                      bool strip_alpha = false);
+                      const RepackOptions& options = RepackOptions());
     
-    // Guess image dimensions from size
+    // Guess image dimensions from size: known sizes from the generic
+    // profile, otherwise every factorization ranked by aspect ratio
     static std::vector<std::pair<uint32_t, uint32_t>> guessDimensions(size_t byte_size,
                                                                        ColorMode mode);
 };
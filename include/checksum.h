@@ -0,0 +1,53 @@
+/**
+ * @file checksum.h
+ * @brief CRC-32, Adler-32 and 64-bit content hashing
+ *
+ * CRC-32 uses slice-by-8 tables, or PCLMULQDQ folding on x86 CPUs that
+ * have it (picked on first use, BOOTMOD_SIMD=scalar forces the tables).
+ * Both checksums follow zlib's convention: start from the initial value
+ * and pass the previous result back in to continue over more data.
+ */
+
+#ifndef BOOTMOD_CHECKSUM_H
+#define BOOTMOD_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "mapped_file.h"
+
+namespace bootmod {
+namespace checksum {
+
+// CRC-32 as used by gzip, PNG and zip, start with 0
+uint32_t crc32(uint32_t crc, ByteSpan data);
+
+// Adler-32 as used by zlib streams, start with 1
+uint32_t adler32(uint32_t adler, ByteSpan data);
+
+// CRC-32 implementation in use: "pclmul" or "slice8"
+const char* crc32KernelName();
+
+// 64-bit content hash (XXH64) for change and duplicate detection, not
+// cryptographic. Data may arrive in pieces of any size.
+class Hash64 {
+public:
+    explicit Hash64(uint64_t seed = 0);
+
+    void update(ByteSpan data);
+    uint64_t finish() const;
+
+private:
+    uint64_t acc_[4];
+    uint64_t seed_;
+    uint64_t total_;
+    uint8_t buffer_[32];
+    size_t buffered_;
+};
+
+// One-shot Hash64
+uint64_t hash64(ByteSpan data, uint64_t seed = 0);
+
+} // namespace checksum
+} // namespace bootmod
+
+#endif // BOOTMOD_CHECKSUM_H
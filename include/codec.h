@@ -0,0 +1,215 @@
+/**
+ * @file codec.h
+ * @brief Pluggable deflate backends
+ *
+ * MTK logo blobs are zlib streams, splash.img images are raw deflate
+ * wrapped in gzip. Both go through CodecContext, which forwards to the
+ * backend selected at runtime: zlib, lodepng's built-in deflate, or
+ * libdeflate when the build found it.
+ */
+
+#ifndef BOOTMOD_CODEC_H
+#define BOOTMOD_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+namespace bootmod {
+
+// Deflate implementation
+enum class CodecBackend {
+    ZLIB,        // System zlib (default)
+    LODEPNG,     // lodepng built-in inflate/deflate
+    LIBDEFLATE   // libdeflate, only if available at build time
+};
+
+// Stream framing
+enum class DeflateFormat {
+    ZLIB,   // zlib header + adler32 (MTK logo.bin)
+    RAW     // Bare deflate (payload of gzip members in splash.img)
+};
+
+// Match finder tuning, only zlib distinguishes these
+enum class DeflateStrategy {
+    DEFAULT,
+    FILTERED   // Favour Huffman coding over short matches (Z_FILTERED)
+};
+
+// Exception class
+class CodecException : public std::runtime_error {
+public:
+    explicit CodecException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+// Interface implemented by every backend.
+// Instances keep internal state and are used by one thread at a time.
+class DeflateBackend {
+public:
+    DeflateBackend() : stream_out_(nullptr), stream_level_(9),
+                       stream_format_(DeflateFormat::ZLIB),
+                       stream_strategy_(DeflateStrategy::DEFAULT), inflate_offset_(0) {}
+    virtual ~DeflateBackend() {}
+
+    virtual CodecBackend kind() const = 0;
+
+    // Worst-case compressed size
+    virtual size_t deflateBound(size_t size, DeflateFormat format) = 0;
+
+    // Compress into dst, returns bytes written (throws if it does not fit)
+    virtual size_t deflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                               int level, DeflateFormat format, DeflateStrategy strategy) = 0;
+
+    // Decompress into dst, returns bytes written (throws if it does not fit)
+    virtual size_t inflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                               DeflateFormat format) = 0;
+
+    // Decompress into a vector, reusing its capacity
+    virtual void inflate(ByteSpan src, std::vector<uint8_t>& out, DeflateFormat format) = 0;
+
+    // Incremental compression into out: one deflateBegin(), any number of
+    // deflateWrite() calls, then deflateFinish(). One-shot backends keep
+    // the input until finish and compress it in one go.
+    virtual void deflateBegin(std::vector<uint8_t>& out, int level, DeflateFormat format,
+                              DeflateStrategy strategy);
+    virtual void deflateWrite(ByteSpan src);
+    virtual void deflateFinish();
+
+    // Incremental decompression: inflateBegin(), then inflateRead() until it
+    // returns 0. Each read fills dst unless the stream ends first. One-shot
+    // backends inflate everything on begin and hand it out in pieces.
+    virtual void inflateBegin(ByteSpan src, DeflateFormat format);
+    
+    // True if inflateRead() decodes on demand, false for one-shot backends
+    // that hold the whole output from inflateBegin() on
+    virtual bool streamsInflate() const { return false; }
+    virtual size_t inflateRead(uint8_t* dst, size_t capacity);
+    
+    // Drop a stream that was not read to the end
+    virtual void inflateEnd();
+
+protected:
+    std::vector<uint8_t>* stream_out_;
+    std::vector<uint8_t> stream_pending_;
+    int stream_level_;
+    DeflateFormat stream_format_;
+    DeflateStrategy stream_strategy_;
+    std::vector<uint8_t> inflate_pending_;
+    size_t inflate_offset_;
+};
+
+// Backend selection
+bool isBackendAvailable(CodecBackend backend);
+void setDefaultBackend(CodecBackend backend);
+CodecBackend getDefaultBackend();
+std::string getBackendName(CodecBackend backend);
+CodecBackend parseBackend(const std::string& name);
+
+// Per-thread codec state.
+// Backend instances are created on first use and reused between slots,
+// and a scratch buffer is kept for callers that decode without allocating.
+class CodecContext {
+public:
+    CodecContext();
+    ~CodecContext();
+
+    // Inflate into a caller buffer, returns bytes written.
+    // Throws if the stream is corrupt or does not fit.
+    size_t inflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       DeflateFormat format = DeflateFormat::ZLIB);
+
+    // Inflate into a vector, reusing its capacity
+    void inflate(ByteSpan src, std::vector<uint8_t>& out,
+                 DeflateFormat format = DeflateFormat::ZLIB);
+
+    // Deflate into a caller buffer of at least deflateBound() bytes, returns bytes written
+    size_t deflateInto(ByteSpan src, uint8_t* dst, size_t capacity, int level = 9,
+                       DeflateFormat format = DeflateFormat::ZLIB,
+                       DeflateStrategy strategy = DeflateStrategy::DEFAULT);
+
+    // Deflate into a vector, reusing its capacity
+    void deflate(ByteSpan src, std::vector<uint8_t>& out, int level = 9,
+                 DeflateFormat format = DeflateFormat::ZLIB,
+                 DeflateStrategy strategy = DeflateStrategy::DEFAULT);
+
+    // Incremental deflate into out, see DeflateBackend::deflateBegin().
+    // The backend is fixed for the stream when it begins.
+    void deflateBegin(std::vector<uint8_t>& out, int level = 9,
+                      DeflateFormat format = DeflateFormat::ZLIB,
+                      DeflateStrategy strategy = DeflateStrategy::DEFAULT);
+    void deflateWrite(ByteSpan src);
+    void deflateFinish();
+
+    // Incremental inflate, see DeflateBackend::inflateBegin().
+    // src must stay valid until the last read.
+    void inflateBegin(ByteSpan src, DeflateFormat format = DeflateFormat::ZLIB);
+    size_t inflateRead(uint8_t* dst, size_t capacity);
+    void inflateEnd();
+
+    // Decompressed size of src. The output goes through a small window and
+    // is dropped, so the whole stream is checked without holding the pixels.
+    // If crc is given it receives the CRC-32 of the output (for gzip footers).
+    // Throws if the stream is corrupt.
+    size_t inflatedSize(ByteSpan src, DeflateFormat format = DeflateFormat::ZLIB,
+                        uint32_t* crc = nullptr);
+
+    // Inflate only the first count bytes of src into dst, returns bytes
+    // written (less if the stream is shorter). Streaming backends stop
+    // decoding there, so sniffing a header costs a fraction of the blob.
+    size_t inflatePeek(ByteSpan src, uint8_t* dst, size_t count,
+                       DeflateFormat format = DeflateFormat::ZLIB);
+
+    // Worst-case deflate output size for the current backend
+    size_t deflateBound(size_t size, DeflateFormat format = DeflateFormat::ZLIB);
+
+    // Backend currently selected by setDefaultBackend()
+    DeflateBackend& backend();
+    
+    // See DeflateBackend::streamsInflate()
+    bool streamsInflate() { return backend().streamsInflate(); }
+
+    // Scratch buffer owned by this context
+    std::vector<uint8_t>& scratch() { return scratch_; }
+
+    // Context of the calling thread
+    static CodecContext& forThread();
+
+private:
+    CodecContext(const CodecContext&);
+    CodecContext& operator=(const CodecContext&);
+
+    std::unique_ptr<DeflateBackend> backends_[3];
+    DeflateBackend* stream_backend_;
+    DeflateBackend* inflate_backend_;
+    std::vector<uint8_t> scratch_;
+    std::vector<uint8_t> deflate_buffer_;
+    std::vector<uint8_t> discard_window_;
+};
+
+// Incremental inflate on a context that is ended when the scope is left,
+// so a read that throws does not keep the stream (or a one-shot backend's
+// whole output) around until the next blob.
+class InflateScope {
+public:
+    InflateScope(CodecContext& codec, ByteSpan src, DeflateFormat format = DeflateFormat::ZLIB)
+        : codec_(codec) {
+        codec_.inflateBegin(src, format);
+    }
+    ~InflateScope() { codec_.inflateEnd(); }
+
+    size_t read(uint8_t* dst, size_t capacity) { return codec_.inflateRead(dst, capacity); }
+
+private:
+    InflateScope(const InflateScope&);
+    InflateScope& operator=(const InflateScope&);
+
+    CodecContext& codec_;
+};
+
+} // namespace bootmod
+
+#endif // BOOTMOD_CODEC_H
@@ -0,0 +1,115 @@
+/**
+ * @file json.h
+ * @brief Minimal JSON output for machine-readable reports
+ *
+ * JsonWriter appends compact JSON to a string and takes care of commas
+ * and escaping. It does not check that the structure is balanced.
+ * JsonValue reads small documents such as batch manifests.
+ */
+
+#ifndef BOOTMOD_JSON_H
+#define BOOTMOD_JSON_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace bootmod {
+
+class JsonWriter {
+public:
+    JsonWriter() : after_key_(false) {}
+    
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    
+    // Member name, the next value or container belongs to it
+    JsonWriter& key(const std::string& name);
+    
+    JsonWriter& value(const std::string& text);
+    JsonWriter& value(const char* text);
+    JsonWriter& value(bool flag);
+    JsonWriter& value(double number);
+    JsonWriter& null();
+    
+    // Value that is already JSON text, e.g. another writer's str()
+    JsonWriter& raw(const std::string& json);
+    
+    // Any integer type
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, JsonWriter&>::type value(T number) {
+        return std::is_signed<T>::value ? signedValue(static_cast<long long>(number))
+                                        : unsignedValue(static_cast<unsigned long long>(number));
+    }
+    
+    // Shorthand for key(name).value(v)
+    template <typename T>
+    JsonWriter& field(const std::string& name, const T& v) {
+        key(name);
+        return value(v);
+    }
+    
+    const std::string& str() const { return out_; }
+    
+private:
+    JsonWriter& signedValue(long long number);
+    JsonWriter& unsignedValue(unsigned long long number);
+    void separate();
+    void appendString(const std::string& text);
+    
+    std::string out_;
+    std::vector<bool> first_;  // Per open container: nothing written into it yet
+    bool after_key_;
+};
+
+// Parse or type error, with the line and column for parse errors
+class JsonException : public std::runtime_error {
+public:
+    explicit JsonException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+// Parsed JSON document. Objects keep their members in file order.
+class JsonValue {
+public:
+    enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+    
+    JsonValue() : type_(Type::NUL), flag_(false), number_(0) {}
+    
+    // Parse a complete document, throws JsonException
+    static JsonValue parse(const std::string& text);
+    
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::NUL; }
+    bool isString() const { return type_ == Type::STRING; }
+    bool isArray() const { return type_ == Type::ARRAY; }
+    bool isObject() const { return type_ == Type::OBJECT; }
+    
+    // Typed access, throw JsonException if the value has another type
+    bool asBool() const;
+    double asNumber() const;
+    uint64_t asUnsigned() const;   // Non-negative integer
+    const std::string& asString() const;
+    const std::vector<JsonValue>& asArray() const;
+    const std::vector<std::pair<std::string, JsonValue>>& members() const;
+    
+    // Object member by name, nullptr if absent or this is not an object
+    const JsonValue* find(const std::string& name) const;
+    
+private:
+    friend class JsonParser;
+    
+    Type type_;
+    bool flag_;
+    double number_;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::vector<std::pair<std::string, JsonValue>> members_;
+};
+
+} // namespace bootmod
+
+#endif // BOOTMOD_JSON_H
@@ -0,0 +1,74 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory-mapped file access
+ *
+ * Lets the logo and splash parsers look at file contents in place instead
+ * of copying them into heap buffers first.
+ */
+
+#ifndef BOOTMOD_MAPPED_FILE_H
+#define BOOTMOD_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bootmod {
+
+// Non-owning view of a contiguous byte range
+struct ByteSpan {
+    const uint8_t* data;
+    size_t size;
+
+    ByteSpan() : data(nullptr), size(0) {}
+    ByteSpan(const uint8_t* d, size_t s) : data(d), size(s) {}
+    ByteSpan(const std::vector<uint8_t>& v) : data(v.data()), size(v.size()) {}
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+    uint8_t operator[](size_t i) const { return data[i]; }
+};
+
+// Read-only mapping of a whole file
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    // Map file into memory, returns false if it cannot be opened or mapped
+    bool open(const std::string& filename);
+
+    // Unmap and release the file
+    void close();
+
+    bool isOpen() const { return is_open_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& filename() const { return filename_; }
+
+    // Get a view of part of the file (caller checks bounds)
+    ByteSpan span(size_t offset, size_t length) const {
+        return ByteSpan(data_ + offset, length);
+    }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    std::string filename_;
+    const uint8_t* data_;
+    size_t size_;
+    bool is_open_;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer_;  // No mmap: file contents are read instead
+#endif
+};
+
+} // namespace bootmod
+
+#endif // BOOTMOD_MAPPED_FILE_H
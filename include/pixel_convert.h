@@ -0,0 +1,38 @@
+/**
+ * @file pixel_convert.h
+ * @brief Vectorized pixel format conversion kernels
+ *
+ * Every kernel has a scalar version and, on x86, SSE2 and AVX2 versions.
+ * The fastest one the CPU supports is picked on first use. Setting
+ * BOOTMOD_SIMD=scalar|sse2|avx2 in the environment caps the choice,
+ * which is handy when comparing outputs.
+ */
+
+#ifndef BOOTMOD_PIXEL_CONVERT_H
+#define BOOTMOD_PIXEL_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bootmod {
+namespace pixel {
+
+// Swap bytes 0 and 2 of every 4-byte pixel (BGRA <-> RGBA).
+// src and dst may be the same buffer.
+void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixel_count);
+
+// Expand 16-bit RGB565 to RGBA8888 with opaque alpha.
+// Channels are shifted up without replicating the top bits.
+void rgb565ToRgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian);
+
+// Pack RGBA8888 to 16-bit RGB565 by truncating each channel, alpha is dropped.
+// src and dst may be the same buffer.
+void rgbaToRgb565(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian);
+
+// Kernel set in use: "avx2", "sse2" or "scalar"
+const char* kernelName();
+
+} // namespace pixel
+} // namespace bootmod
+
+#endif // BOOTMOD_PIXEL_CONVERT_H
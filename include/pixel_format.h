@@ -0,0 +1,167 @@
+/**
+ * @file pixel_format.h
+ * @brief Compile-time pixel format traits and conversions
+ *
+ * Each ColorMode has a PixelFormat specialization that loads a pixel
+ * into RGBA channels and stores it back. convertPixels<From, To> stamps
+ * out one loop per (from, to) pair. Pairs that map onto a SIMD kernel
+ * in pixel_convert.h use it instead.
+ */
+
+#ifndef BOOTMOD_PIXEL_FORMAT_H
+#define BOOTMOD_PIXEL_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "bootmod.h"
+#include "pixel_convert.h"
+
+namespace mtklogo {
+
+// Channel values of one pixel
+struct Rgba {
+    uint8_t r, g, b, a;
+};
+
+template <ColorMode Mode> struct PixelFormat;
+
+// Helper: 32-bit formats, R, G, B and A are the byte offsets of each channel
+template <int R, int G, int B, int A>
+struct Pixel32 {
+    static const size_t BYTES = 4;
+    
+    static Rgba load(const uint8_t* p) {
+        Rgba c = {p[R], p[G], p[B], p[A]};
+        return c;
+    }
+    
+    static void store(uint8_t* p, Rgba c) {
+        p[R] = c.r;
+        p[G] = c.g;
+        p[B] = c.b;
+        p[A] = c.a;
+    }
+};
+
+// Helper: 16-bit R5G6B5 word, channels widened without bit replication
+template <bool BigEndian>
+struct Pixel565 {
+    static const size_t BYTES = 2;
+    
+    static Rgba load(const uint8_t* p) {
+        uint16_t v = BigEndian ? static_cast<uint16_t>((p[0] << 8) | p[1])
+                               : static_cast<uint16_t>(p[0] | (p[1] << 8));
+        Rgba c = {static_cast<uint8_t>((v >> 8) & 0xF8),
+                  static_cast<uint8_t>((v >> 3) & 0xFC),
+                  static_cast<uint8_t>((v << 3) & 0xF8),
+                  0xFF};
+        return c;
+    }
+    
+    static void store(uint8_t* p, Rgba c) {
+        uint16_t v = static_cast<uint16_t>(((c.r >> 3) << 11) | ((c.g >> 2) << 5) | (c.b >> 3));
+        p[BigEndian ? 0 : 1] = static_cast<uint8_t>(v >> 8);
+        p[BigEndian ? 1 : 0] = static_cast<uint8_t>(v & 0xFF);
+    }
+};
+
+template <> struct PixelFormat<ColorMode::RGBA_BE> : Pixel32<0, 1, 2, 3> {};
+template <> struct PixelFormat<ColorMode::RGBA_LE> : Pixel32<3, 2, 1, 0> {};
+template <> struct PixelFormat<ColorMode::BGRA_BE> : Pixel32<2, 1, 0, 3> {};
+template <> struct PixelFormat<ColorMode::BGRA_LE> : Pixel32<1, 2, 3, 0> {};
+template <> struct PixelFormat<ColorMode::RGB565_BE> : Pixel565<true> {};
+template <> struct PixelFormat<ColorMode::RGB565_LE> : Pixel565<false> {};
+
+// Convert pixel_count pixels from src to dst.
+// Buffers must not overlap unless convertPixelsInPlace allows it.
+template <ColorMode From, ColorMode To>
+struct PixelConverter {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        typedef PixelFormat<From> In;
+        typedef PixelFormat<To> Out;
+        for (size_t i = 0; i < pixel_count; i++) {
+            Out::store(dst + i * Out::BYTES, In::load(src + i * In::BYTES));
+        }
+    }
+};
+
+// Identity
+template <ColorMode Mode>
+struct PixelConverter<Mode, Mode> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        if (src != dst) {
+            memcpy(dst, src, pixel_count * PixelFormat<Mode>::BYTES);
+        }
+    }
+};
+
+// Pairs backed by SIMD kernels
+template <>
+struct PixelConverter<ColorMode::RGBA_BE, ColorMode::BGRA_BE> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        bootmod::pixel::swapRedBlue(src, dst, pixel_count);
+    }
+};
+
+template <>
+struct PixelConverter<ColorMode::BGRA_BE, ColorMode::RGBA_BE>
+    : PixelConverter<ColorMode::RGBA_BE, ColorMode::BGRA_BE> {};
+
+template <>
+struct PixelConverter<ColorMode::RGB565_BE, ColorMode::RGBA_BE> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        bootmod::pixel::rgb565ToRgba(src, dst, pixel_count, true);
+    }
+};
+
+template <>
+struct PixelConverter<ColorMode::RGB565_LE, ColorMode::RGBA_BE> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        bootmod::pixel::rgb565ToRgba(src, dst, pixel_count, false);
+    }
+};
+
+template <>
+struct PixelConverter<ColorMode::RGBA_BE, ColorMode::RGB565_BE> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        bootmod::pixel::rgbaToRgb565(src, dst, pixel_count, true);
+    }
+};
+
+template <>
+struct PixelConverter<ColorMode::RGBA_BE, ColorMode::RGB565_LE> {
+    static void run(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+        bootmod::pixel::rgbaToRgb565(src, dst, pixel_count, false);
+    }
+};
+
+// Convert in place. Same-size and shrinking conversions walk forwards,
+// growing ones backwards, so no pixel is overwritten before it is read.
+// The SIMD kernels load each block before storing it, which keeps them
+// safe going forwards. The buffer must hold pixel_count pixels of the
+// larger format.
+template <ColorMode From, ColorMode To>
+void convertPixelsInPlace(uint8_t* data, size_t pixel_count) {
+    typedef PixelFormat<From> In;
+    typedef PixelFormat<To> Out;
+    
+    if (Out::BYTES <= In::BYTES) {
+        PixelConverter<From, To>::run(data, data, pixel_count);
+    } else {
+        for (size_t i = pixel_count; i-- > 0;) {
+            Out::store(data + i * Out::BYTES, In::load(data + i * In::BYTES));
+        }
+    }
+}
+
+// Runtime (from, to) dispatch onto the compiled converters
+typedef void (*PixelConvertFn)(const uint8_t* src, uint8_t* dst, size_t pixel_count);
+typedef void (*PixelConvertInPlaceFn)(uint8_t* data, size_t pixel_count);
+
+PixelConvertFn getPixelConverter(ColorMode from, ColorMode to);
+PixelConvertInPlaceFn getInPlacePixelConverter(ColorMode from, ColorMode to);
+
+} // namespace mtklogo
+
+#endif // BOOTMOD_PIXEL_FORMAT_H
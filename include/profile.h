@@ -0,0 +1,88 @@
+/**
+ * @file profile.h
+ * @brief Device resolution profiles for logo dimension lookup
+ *
+ * A logo blob only tells us its decompressed size, so the image
+ * dimensions have to come from somewhere. Each profile indexes its
+ * resolutions by frame size and bytes per pixel, which makes a lookup
+ * a single hash probe. The built-in "generic" profile holds the common
+ * panel and icon sizes; device profiles are loaded from a text file:
+ *
+ *   # comment
+ *   device <name>
+ *   resolution <W>x<H> [<W>x<H> ...]   # tried in the order listed
+ *   slot <n> <W>x<H>                   # fixed geometry of slot n (1-based)
+ */
+
+#ifndef BOOTMOD_PROFILE_H
+#define BOOTMOD_PROFILE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bootmod.h"
+
+namespace mtklogo {
+
+typedef std::pair<uint32_t, uint32_t> Dimensions;  // Width, height
+
+// Resolutions and slot layout of one device
+class DeviceProfile {
+public:
+    explicit DeviceProfile(const std::string& name = std::string()) : name_(name) {}
+    
+    const std::string& name() const { return name_; }
+    
+    // Add a resolution, earlier ones win when several share a frame size
+    void addResolution(uint32_t width, uint32_t height);
+    
+    // Pin the geometry of one slot
+    void setSlot(size_t id, uint32_t width, uint32_t height);
+    
+    // Resolutions whose frame is byte_size bytes in mode, best first
+    const std::vector<Dimensions>& lookup(size_t byte_size, ColorMode mode) const;
+    
+    // Slot geometry if pinned and matching byte_size, otherwise the best lookup() hit.
+    // Returns false if the profile knows no fitting size.
+    bool dimensionsFor(size_t id, size_t byte_size, ColorMode mode, Dimensions& out) const;
+
+private:
+    static uint64_t key(uint64_t byte_size, uint32_t bpp) { return (byte_size << 3) | bpp; }
+    
+    std::string name_;
+    std::unordered_map<uint64_t, std::vector<Dimensions>> by_size_;
+    std::map<size_t, Dimensions> slots_;
+};
+
+// Named device profiles
+class ProfileDatabase {
+public:
+    // Parse profiles from text, later definitions of a device extend it.
+    // Throws MtkLogoException with the source and line on syntax errors.
+    void parse(const std::string& text, const std::string& source);
+    
+    // Parse a profile file
+    void loadFile(const std::string& path);
+    
+    // Profile by device name, nullptr if unknown
+    const DeviceProfile* find(const std::string& name) const;
+    
+    // Device names, sorted
+    std::vector<std::string> names() const;
+    
+    // Built-in profiles, parsed once on first use
+    static const ProfileDatabase& builtin();
+    
+    // The built-in "generic" profile used by MtkLogo::guessDimensions()
+    static const DeviceProfile& generic();
+
+private:
+    std::map<std::string, DeviceProfile> profiles_;
+};
+
+} // namespace mtklogo
+
+#endif // BOOTMOD_PROFILE_H
@@ -0,0 +1,70 @@
+/**
+ * @file project.h
+ * @brief Unpack manifest for incremental repacking
+ *
+ * unpack records every image it writes together with a copy of the
+ * original logo.bin. repack uses it to copy the original compressed
+ * blob of any image that has not been edited since, so only changed
+ * slots are decoded and compressed again.
+ */
+
+#ifndef BOOTMOD_PROJECT_H
+#define BOOTMOD_PROJECT_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "bootmod.h"
+
+namespace mtklogo {
+
+// One image written by unpack
+struct ManifestEntry {
+    size_t id;             // Slot number (1-based)
+    ColorMode mode;        // Pixel format the image was exported with
+    uint64_t file_size;    // Size of the image file as written
+    uint64_t file_hash;    // ImageUtils::hashBytes() of the image file
+    std::string file;      // File name, relative to the manifest directory
+};
+
+// Manifest and original image kept next to unpacked images
+class ProjectManifest {
+public:
+    static const char* MANIFEST_NAME;   // "bootmod.manifest"
+    static const char* ORIGINAL_NAME;   // "original.bin"
+    
+    std::vector<ManifestEntry> entries;
+    
+    // Record an image file just written to dir (file name relative to dir)
+    void add(const std::string& dir, size_t id, ColorMode mode, const std::string& file);
+    
+    // Write the manifest and a copy of the original logo.bin into dir
+    void save(const std::string& dir, const std::string& original_file) const;
+    
+    // Load the manifest from dir. Returns false if dir has none, it was
+    // written with a different hash, or it does not match a readable
+    // original.bin; repack then recompresses every slot.
+    bool load(const std::string& dir);
+    
+    // Entry for an image path if it is the same file the entry was written
+    // to and unchanged since unpack, else nullptr
+    const ManifestEntry* findUnchanged(const std::string& path) const;
+    
+    // Original compressed blob of an entry (valid while the manifest is alive)
+    bootmod::ByteSpan originalBlob(const ManifestEntry& entry) const;
+    
+    // Hash a file's contents, optionally returning its size
+    static uint64_t hashFile(const std::string& path, uint64_t* size = nullptr);
+
+private:
+    // Parse manifest lines into entries, throws on malformed lines
+    void readEntries(std::istream& in);
+    
+    std::string dir_;
+    LogoImageView original_;
+};
+
+} // namespace mtklogo
+
+#endif // BOOTMOD_PROJECT_H
@@ -0,0 +1,48 @@
+/**
+ * @file server.h
+ * @brief Resident request server over a Unix domain socket
+ *
+ * `bootmod serve` keeps opened images, their info and the slots extracted
+ * from them in memory, so tools that ask about the same files again and
+ * again skip the parse and decode after the first request.
+ *
+ * Every frame is a 4-byte little-endian length followed by that many
+ * bytes. A request is one JSON frame such as {"cmd": "info", "file": ...};
+ * the reply is one JSON frame with "ok" (and "error" when false). Replies
+ * with a "data_size" member are followed by one binary frame of that size.
+ */
+
+#ifndef BOOTMOD_SERVER_H
+#define BOOTMOD_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bootmod {
+
+// Settings of a server process
+struct ServerOptions {
+    std::string socket_path;
+    size_t cache_limit;     // Bytes of extracted slots kept in memory
+
+    // `info --json` object for a file, throws if the file cannot be read
+    std::function<std::string(const std::string&)> describe;
+
+    ServerOptions() : cache_limit(256u << 20) {}
+};
+
+// Serve until a shutdown request, SIGINT or SIGTERM. Returns the exit code.
+int runServer(const ServerOptions& options);
+
+// Send one request and return the JSON reply. data receives the binary
+// frame that follows a reply with "data_size". Throws std::runtime_error
+// on connection or protocol errors.
+std::string callServer(const std::string& socket_path, const std::string& request,
+                       std::vector<uint8_t>* data = nullptr);
+
+} // namespace bootmod
+
+#endif // BOOTMOD_SERVER_H
@@ -11,8 +11,11 @@
 #define BOOTMOD_SPLASH_H
 
 #include <stdint.h>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
+#include "mapped_file.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -79,6 +82,10 @@ typedef struct {
 #endif
 
 namespace bootmod {
+
+class ThreadPool;
+struct SlotStats;
+
 namespace splash {
 
 /**
@@ -86,13 +93,26 @@ namespace splash {
  */
 struct ImageInfo {
     std::string name;
-    uint32_t width;
-    uint32_t height;
+    uint32_t width;                 // From the image's BMP header, else the display width
+    uint32_t height;                // From the image's BMP header, else the display height
+    uint16_t bpp;                   // BMP bits per pixel, 0 if the header could not be read
     uint32_t offset;
     uint32_t compressed_size;
     uint32_t uncompressed_size;
 };
 
+/**
+ * @brief Result of SplashImage::verify() for one image
+ */
+struct ImageCheck {
+    uint32_t inflated_size;         // 0 unless the image inflated
+    uint32_t crc32;                 // CRC-32 of the inflated data
+    std::string error;              // Why the image is broken, empty if it is sound
+    std::string warning;            // Usable but suspicious, e.g. larger than the display
+    
+    ImageCheck() : inflated_size(0), crc32(0) {}
+};
+
 /**
  * @brief Splash image class for OPPO/OnePlus devices
  */
@@ -101,8 +121,22 @@ public:
     SplashImage();
     ~SplashImage();
     
+    /**
+     * @brief Send diagnostics to a string instead of stderr
+     *
+     * Messages are appended one per line. Appends are serialized, so
+     * threads extracting from the same object may share the log.
+     *
+     * @param log String to append to, null prints to stderr again
+     */
+    void setLog(std::string* log) { log_ = log; }
+    
     /**
      * @brief Load splash.img file
+     *
+     * The file stays mapped while the object lives. Images are read from
+     * the mapping on demand and only copied once they are replaced.
+     *
      * @param filename Path to splash.img
      * @return true if successful
      */
@@ -110,11 +144,30 @@ public:
     
     /**
      * @brief Save splash.img file
+     *
+     * Saving over the loaded file patches it in place (see savePatch()).
+     * If its layout does not allow that, a temporary file is written next
+     * to it and renamed into place, so the mapping is never truncated
+     * under us.
+     *
      * @param filename Output path
      * @return true if successful
      */
     bool save(const std::string& filename);
     
+    /**
+     * @brief Write changes back into the loaded file in place
+     *
+     * Only the metadata table and replaced images are written. A replaced
+     * image that still fits its old slot keeps its offset. From the first
+     * one that does not, later images are moved up behind it. The file is
+     * mapped again afterwards. An I/O error midway leaves it half patched.
+     *
+     * @param bytes_written Optional, set to the number of bytes written
+     * @return true if successful, false if nothing could be written
+     */
+    bool savePatch(size_t* bytes_written = nullptr);
+    
     /**
      * @brief Get number of images
      */
@@ -132,6 +185,10 @@ public:
     
     /**
      * @brief Get image information
+     *
+     * Width, height and bpp come from the image's own BMP header. Only its
+     * first 54 bytes are inflated, once, and cached.
+     *
      * @param index Image index (0-based)
      */
     ImageInfo getImageInfo(uint32_t index) const;
@@ -146,11 +203,63 @@ public:
     
     /**
      * @brief Extract image as PNG
+     *
+     * Does not modify the object and decodes into per-thread buffers, so
+     * several threads may extract from one SplashImage at once.
+     *
      * @param index Image index
      * @param output_path Output PNG file path
      * @return true if successful
      */
-    bool extractImage(uint32_t index, const std::string& output_path);
+    bool extractImage(uint32_t index, const std::string& output_path) const;
+    
+    /**
+     * @brief Encode an image as PNG into memory, as extractImage() would write it
+     * @param index Image index
+     * @param png Receives the PNG file contents
+     * @return true if successful
+     */
+    bool extractImage(uint32_t index, std::vector<uint8_t>& png) const;
+    
+    /**
+     * @brief Extract every image as PNG on a thread pool
+     * @param output_path Returns the PNG path for an image index
+     * @param jobs Worker threads, 0 uses every CPU core
+     * @param progress Called in index order with each result, stops after the first failure
+     * @param stats Receives sizes and stage timings per image if given
+     * @return true if all images were extracted
+     *
+     * Images after the first failure are not started. The error of the
+     * failed image goes to stderr and into its stats entry.
+     */
+    bool extractAll(const std::function<std::string(uint32_t)>& output_path,
+                    size_t jobs = 0,
+                    const std::function<void(uint32_t, bool)>& progress =
+                        std::function<void(uint32_t, bool)>(),
+                    std::vector<SlotStats>* stats = nullptr) const;
+    
+    /**
+     * @brief Extract every image as PNG on a pool shared with other work
+     */
+    bool extractAll(const std::function<std::string(uint32_t)>& output_path,
+                    ThreadPool& pool,
+                    const std::function<void(uint32_t, bool)>& progress =
+                        std::function<void(uint32_t, bool)>(),
+                    std::vector<SlotStats>* stats = nullptr) const;
+    
+    /**
+     * @brief Check every image without decoding pixels or writing anything
+     *
+     * Images must follow each other in the data area without overlapping,
+     * carry a plain gzip header, inflate in full, and match the CRC-32 and
+     * size in their gzip footer and the metadata table. The BMP header must
+     * describe no more pixels than the image holds. Output is inflated into
+     * a discard window.
+     *
+     * @param pool Spreads the images over its workers if given
+     * @return One result per image
+     */
+    std::vector<ImageCheck> verify(ThreadPool* pool = nullptr) const;
     
     /**
      * @brief Replace image from PNG
@@ -160,6 +269,25 @@ public:
      */
     bool replaceImage(uint32_t index, const std::string& png_path);
     
+    /**
+     * @brief Get the decompressed size of an image without keeping its data
+     * @param index Image index
+     * @param size Output decompressed size
+     * @return true if the image inflates cleanly
+     */
+    bool probeImage(uint32_t index, size_t& size) const;
+    
+    /**
+     * @brief Decompress only the start of an image, e.g. its BMP header
+     * @param index Image index
+     * @param count Number of bytes wanted
+     * @param output Resized to the bytes decoded (count unless the image is shorter)
+     * @param error Receives the error message instead of stderr if given
+     * @return true if successful
+     */
+    bool peekImage(uint32_t index, size_t count, std::vector<uint8_t>& output,
+                   std::string* error = nullptr) const;
+    
     /**
      * @brief Get raw BMP data for an image
      * @param index Image index
@@ -167,7 +295,7 @@ public:
      * @param height Output height
      * @return BMP data
      */
-    std::vector<uint8_t> getImageData(uint32_t index, uint32_t& width, uint32_t& height);
+    std::vector<uint8_t> getImageData(uint32_t index, uint32_t& width, uint32_t& height) const;
     
     /**
      * @brief Check if file is a valid splash.img
@@ -177,21 +305,55 @@ public:
     static bool isValidSplash(const std::string& filename);
     
 private:
+    // Geometry from an image's BMP header, read on first use
+    struct BmpGeometry {
+        bool probed;
+        bool valid;
+        uint32_t width;
+        uint32_t height;
+        uint16_t bpp;
+        
+        BmpGeometry() : probed(false), valid(false), width(0), height(0), bpp(0) {}
+    };
+    
     bool parseHeader();
-    bool decompressImage(uint32_t index, std::vector<uint8_t>& output);
+    // Print a diagnostic or append it to the log, always false
+    bool report(const std::string& message) const;
+    // Hand message to the caller if it collects errors, else report() it
+    bool fail(std::string* error, const std::string& message) const;
+    bool deflateStream(ByteSpan compressed, ByteSpan& stream, std::string* error = nullptr) const;
+    bool extractOn(ThreadPool* pool, const std::function<std::string(uint32_t)>& output_path,
+                   const std::function<void(uint32_t, bool)>& progress,
+                   std::vector<SlotStats>* stats) const;
+    // extractImage() that hands its error message back instead of printing it
+    bool extractImage(uint32_t index, const std::string& output_path, std::string& error) const;
+    bool encodeImage(uint32_t index, std::vector<uint8_t>& png, std::string& error) const;
+    bool canPatch() const;
+    BmpGeometry bmpGeometry(uint32_t index) const;
+    bool decompressImage(uint32_t index, std::vector<uint8_t>& output,
+                         std::string* error = nullptr) const;
     bool compressImage(const std::vector<uint8_t>& input, std::vector<uint8_t>& output);
     
     std::string filename_;
     ddph_hdr_t ddph_header_;
     oppo_splash_hdr_t splash_header_;
     std::vector<splash_metadata_hdr_t> metadata_;
+    std::vector<splash_metadata_hdr_t> file_metadata_;  // As stored in the loaded file
     
     bool has_ddph_;
     uint32_t image_count_;
     uint32_t width_;
     uint32_t height_;
     
-    std::vector<std::vector<uint8_t>> image_data_;  // Cached compressed data
+    MappedFile file_;
+    std::vector<ByteSpan> image_data_;              // Compressed data, in file_ or replaced_
+    std::vector<std::vector<uint8_t>> replaced_;    // Owned data of replaced images
+    
+    mutable std::vector<BmpGeometry> geometry_;
+    mutable std::mutex geometry_mutex_;             // getImageInfo() may run on several threads
+    
+    std::string* log_;                              // Diagnostics, null for stderr
+    mutable std::mutex log_mutex_;
 };
 
 } // namespace splash
@@ -0,0 +1,117 @@
+/**
+ * @file stats.h
+ * @brief Per-stage timings and byte counts behind the --stats option
+ *
+ * Code that does a timed piece of work opens a StageTimer for its stage.
+ * Timers only record while the calling thread is inside a StatsScope, so
+ * untracked runs pay one thread-local read per timer. A nested timer
+ * pauses the enclosing one, each stage gets its own time only. Tasks
+ * queued on a TaskGroup inherit the scope they were queued from.
+ */
+
+#ifndef BOOTMOD_STATS_H
+#define BOOTMOD_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bootmod {
+
+// Stages of the unpack/repack/extract/replace pipelines
+enum class Stage {
+    READ,          // Input files
+    INFLATE,
+    CONVERT,       // Pixel format conversion
+    PNG_DECODE,
+    PNG_ENCODE,
+    DEFLATE,
+    HASH,          // Content hashes, CRCs and duplicate compares
+    WRITE          // Output files
+};
+
+static const size_t STAGE_COUNT = 8;
+
+// Stage name as used in JSON, e.g. "png_encode"
+const char* stageName(Stage stage);
+
+// Time per stage and bytes read and written by one slot or a whole run.
+// Several threads may add to the same object.
+class StageStats {
+public:
+    StageStats();
+    StageStats(const StageStats& other);
+    StageStats& operator=(const StageStats& other);
+
+    void addTime(Stage stage, uint64_t nanoseconds);
+    void addBytes(uint64_t in, uint64_t out);
+    void add(const StageStats& other);
+
+    double seconds(Stage stage) const;
+    double totalSeconds() const;
+    uint64_t bytesIn() const { return bytes_in_.load(); }
+    uint64_t bytesOut() const { return bytes_out_.load(); }
+
+private:
+    std::atomic<uint64_t> nanos_[STAGE_COUNT];
+    std::atomic<uint64_t> bytes_in_;
+    std::atomic<uint64_t> bytes_out_;
+};
+
+// One slot or image of a run
+struct SlotStats {
+    size_t index;             // As the user counts it: MTK from 1, splash from 0
+    std::string file;         // File written (unpack) or read (repack)
+    uint32_t width;
+    uint32_t height;
+    uint64_t frame_bytes;     // Decoded pixels
+    uint64_t stored_bytes;    // Compressed data inside the image
+    std::string error;        // Why the slot could not be written, empty if it was
+    StageStats stages;
+
+    SlotStats() : index(0), width(0), height(0), frame_bytes(0), stored_bytes(0) {}
+};
+
+// Records the calling thread's timers into stats until it goes out of
+// scope. nullptr stops recording, e.g. for work that is counted elsewhere.
+class StatsScope {
+public:
+    explicit StatsScope(StageStats* stats);
+    ~StatsScope();
+
+    // Stats the calling thread records into, nullptr outside any scope
+    static StageStats* current();
+
+private:
+    StatsScope(const StatsScope&);
+    StatsScope& operator=(const StatsScope&);
+
+    StageStats* saved_stats_;
+    int saved_stage_;
+};
+
+// Adds the time until it is destroyed to a stage of the current scope
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage);
+    ~StageTimer();
+
+private:
+    StageTimer(const StageTimer&);
+    StageTimer& operator=(const StageTimer&);
+
+    bool active_;
+    int previous_;
+};
+
+// Count bytes read and written in the current scope
+void countBytes(uint64_t in, uint64_t out);
+
+// Highest resident set size of the process so far, 0 where unknown
+uint64_t peakResidentBytes();
+
+} // namespace bootmod
+
+#endif // BOOTMOD_STATS_H
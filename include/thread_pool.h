@@ -0,0 +1,176 @@
+/**
+ * @file thread_pool.h
+ * @brief Work-stealing thread pool used for per-slot parallelism
+ *
+ * Every worker owns a task deque for the tasks it queues itself; tasks
+ * from other threads go to one shared deque. Workers run their own tasks,
+ * then shared ones, then steal from other workers, always taking the
+ * oldest task, so tasks start in the order they were queued. Threads that
+ * wait for results (TaskGroup::wait, orderedParallelFor) run queued tasks
+ * themselves, so pools can be shared by nested operations without
+ * deadlocking.
+ */
+
+#ifndef BOOTMOD_THREAD_POOL_H
+#define BOOTMOD_THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bootmod {
+
+class ThreadPool {
+public:
+    // Start a pool, 0 threads means one per CPU core
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    // Queue a task
+    void submit(std::function<void()> task);
+
+    // Run one queued task on the calling thread, false if nothing was queued
+    bool runPendingTask();
+
+    // Number of worker threads
+    size_t getThreadCount() const { return threads_.size(); }
+
+    // Number of CPU cores (at least 1)
+    static size_t defaultThreadCount();
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool popOldest(WorkQueue& queue, std::function<void()>& task);
+    // home is the worker's queue index, queues_.size() for other threads
+    bool popTask(size_t home, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    WorkQueue injected_;    // Tasks submitted from outside the pool
+    std::vector<std::thread> threads_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<long> pending_;
+    bool stopping_;
+};
+
+// Set of tasks that can be waited for as a unit.
+// The first exception thrown by a task is rethrown from wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    ~TaskGroup();
+
+    // Queue a task in this group
+    void run(std::function<void()> task);
+
+    // Wait for all tasks, helping the pool meanwhile
+    void wait();
+
+private:
+    TaskGroup(const TaskGroup&);
+    TaskGroup& operator=(const TaskGroup&);
+
+    ThreadPool& pool_;
+    std::atomic<size_t> outstanding_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Run produce(i) for every i in [0, count) on the pool and pass the
+ *        results to consume(i, result) on the calling thread in index order.
+ *
+ * Results are consumed as soon as all earlier indices are done, so output
+ * stays deterministic while the work runs concurrently. Without a pool
+ * everything runs serially on the calling thread. An exception from
+ * produce(i) is rethrown when index i is reached; later slots are skipped.
+ */
+template <typename Result>
+void orderedParallelFor(ThreadPool* pool,
+                        size_t count,
+                        const std::function<Result(size_t)>& produce,
+                        const std::function<void(size_t, Result&)>& consume) {
+    if (!pool || count < 2) {
+        for (size_t i = 0; i < count; i++) {
+            Result result = produce(i);
+            consume(i, result);
+        }
+        return;
+    }
+
+    std::vector<Result> results(count);
+    std::vector<std::exception_ptr> errors(count);
+    std::unique_ptr<std::atomic<bool>[]> ready(new std::atomic<bool>[count]);
+    for (size_t i = 0; i < count; i++) {
+        ready[i] = false;
+    }
+
+    std::atomic<bool> cancelled(false);
+    std::mutex mutex;
+    std::condition_variable slot_done;
+
+    TaskGroup group(*pool);
+    for (size_t i = 0; i < count; i++) {
+        group.run([&, i]() {
+            if (!cancelled) {
+                try {
+                    results[i] = produce(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready[i] = true;
+            }
+            slot_done.notify_all();
+        });
+    }
+
+    try {
+        for (size_t i = 0; i < count; i++) {
+            while (!ready[i]) {
+                if (!pool->runPendingTask()) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    slot_done.wait_for(lock, std::chrono::milliseconds(10),
+                                       [&]() { return ready[i].load(); });
+                }
+            }
+
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+
+            consume(i, results[i]);
+            results[i] = Result();
+        }
+    } catch (...) {
+        cancelled = true;
+        group.wait();
+        throw;
+    }
+
+    group.wait();
+}
+
+} // namespace bootmod
+
+#endif // BOOTMOD_THREAD_POOL_H
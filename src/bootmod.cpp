@@ -1,13 +1,38 @@
 #include "bootmod.h"
+#include "checksum.h"
+#include "stats.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <cstring>
-#include <zlib.h>
+#include <cstdio>
+#include <cstdarg>
 
 namespace bootmod {
 
+void appendFormat(std::string& out, const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    
+    if (length < 0) {
+        return;
+    }
+    
+    if (static_cast<size_t>(length) < sizeof(buffer)) {
+        out.append(buffer, length);
+    } else {
+        std::vector<char> large(length + 1);
+        va_start(args, format);
+        vsnprintf(large.data(), large.size(), format, args);
+        va_end(args);
+        out.append(large.data(), length);
+    }
+}
+
 // Format detection implementation
 FormatType detectFormat(const std::string& filename) {
     std::ifstream file(filename, std::ios::binary);
@@ -234,24 +259,7 @@ uint32_t LogoTable::getBlobSize(size_t index) const {
 // ============================================================================
 
 LogoImage LogoImage::readFromFile(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        throw MtkLogoException("Cannot open file: " + filename);
-    }
-    
-    // Read entire file
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<uint8_t> buffer(size);
-    file.read(reinterpret_cast<char*>(buffer.data()), size);
-    
-    if (!file) {
-        throw MtkLogoException("Failed to read file: " + filename);
-    }
-    
-    return read(buffer.data(), size);
+    return LogoImageView::open(filename).toLogoImage();
 }
 
 LogoImage LogoImage::read(const uint8_t* data, size_t length) {
@@ -302,18 +310,13 @@ LogoImage LogoImage::createFromBlobs(const std::vector<std::vector<uint8_t>>& bl
 }
 
 void LogoImage::writeToFile(const std::string& filename) const {
-    std::vector<uint8_t> buffer = write();
+    LogoImageWriter writer(filename, blobs.size());
     
-    std::ofstream file(filename, std::ios::binary);
-    if (!file) {
-        throw MtkLogoException("Cannot create file: " + filename);
+    for (const auto& blob : blobs) {
+        writer.append(blob);
     }
     
-    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    
-    if (!file) {
-        throw MtkLogoException("Failed to write file: " + filename);
-    }
+    writer.finish();
 }
 
 std::vector<uint8_t> LogoImage::write() const {
@@ -332,77 +335,192 @@ std::vector<uint8_t> LogoImage::write() const {
 }
 
 // ============================================================================
-// ImageUtils Implementation
+// LogoImageView Implementation
 // ============================================================================
 
-std::vector<uint8_t> ImageUtils::zlibDecompress(const std::vector<uint8_t>& compressed) {
-    z_stream stream = {};
-    stream.next_in = const_cast<uint8_t*>(compressed.data());
-    stream.avail_in = compressed.size();
+LogoImageView LogoImageView::open(const std::string& filename) {
+    bootmod::StageTimer timer(bootmod::Stage::READ);
+    LogoImageView view;
     
-    if (inflateInit(&stream) != Z_OK) {
-        throw MtkLogoException("Failed to initialize zlib inflation");
+    if (!view.file_.open(filename)) {
+        throw MtkLogoException("Cannot open file: " + filename);
     }
     
-    std::vector<uint8_t> decompressed;
-    const size_t CHUNK_SIZE = 16384;
+    const uint8_t* data = view.file_.data();
+    size_t length = view.file_.size();
     
-    int ret;
-    do {
-        uint8_t out_buffer[CHUNK_SIZE];
-        stream.next_out = out_buffer;
-        stream.avail_out = CHUNK_SIZE;
-        
-        ret = inflate(&stream, Z_NO_FLUSH);
+    // Read logo table
+    view.table = LogoTable::read(data, length);
+    
+    // Point at blobs inside the mapping
+    const uint8_t* blob_data = data + MtkHeader::SIZE;
+    
+    view.blobs_.reserve(view.table.logo_count);
+    for (size_t i = 0; i < view.table.logo_count; i++) {
+        uint32_t offset = view.table.offsets[i];
+        uint32_t size = view.table.getBlobSize(i);
         
-        if (ret != Z_OK && ret != Z_STREAM_END) {
-            inflateEnd(&stream);
-            throw MtkLogoException("Zlib decompression failed");
+        if (MtkHeader::SIZE + static_cast<size_t>(offset) + size > length) {
+            throw MtkLogoException("Blob exceeds buffer size");
         }
         
-        size_t have = CHUNK_SIZE - stream.avail_out;
-        decompressed.insert(decompressed.end(), out_buffer, out_buffer + have);
-        
-    } while (ret != Z_STREAM_END);
+        view.blobs_.push_back(bootmod::ByteSpan(blob_data + offset, size));
+    }
     
-    inflateEnd(&stream);
-    return decompressed;
+    return view;
 }
 
-std::vector<uint8_t> ImageUtils::zlibCompress(const std::vector<uint8_t>& data, int level) {
-    z_stream stream = {};
-    stream.next_in = const_cast<uint8_t*>(data.data());
-    stream.avail_in = data.size();
+bootmod::ByteSpan LogoImageView::blob(size_t index) const {
+    if (index >= blobs_.size()) {
+        throw MtkLogoException("Blob index out of range");
+    }
+    return blobs_[index];
+}
+
+LogoImage LogoImageView::toLogoImage() const {
+    LogoImage image;
+    image.table = table;
     
-    if (deflateInit(&stream, level) != Z_OK) {
-        throw MtkLogoException("Failed to initialize zlib deflation");
+    image.blobs.reserve(blobs_.size());
+    for (const auto& blob : blobs_) {
+        image.blobs.push_back(std::vector<uint8_t>(blob.begin(), blob.end()));
     }
     
-    std::vector<uint8_t> compressed;
-    const size_t CHUNK_SIZE = 16384;
+    return image;
+}
+
+// ============================================================================
+// LogoImageWriter Implementation
+// ============================================================================
+
+LogoImageWriter::LogoImageWriter(const std::string& filename, size_t logo_count)
+    : filename_(filename)
+    , temp_filename_(filename + ".tmp")
+    , file_(temp_filename_, std::ios::binary | std::ios::trunc)
+    , expected_count_(logo_count)
+    , finished_(false) {
+    if (!file_) {
+        throw MtkLogoException("Cannot create file: " + temp_filename_);
+    }
     
-    int ret;
-    do {
-        uint8_t out_buffer[CHUNK_SIZE];
-        stream.next_out = out_buffer;
-        stream.avail_out = CHUNK_SIZE;
-        
-        ret = deflate(&stream, Z_FINISH);
-        
-        if (ret != Z_OK && ret != Z_STREAM_END) {
-            deflateEnd(&stream);
-            throw MtkLogoException("Zlib compression failed");
-        }
-        
-        size_t have = CHUNK_SIZE - stream.avail_out;
-        compressed.insert(compressed.end(), out_buffer, out_buffer + have);
-        
-    } while (ret != Z_STREAM_END);
+    table_.header.mtk_type = MtkType::LOGO;
+    table_.logo_count = logo_count;
+    table_.offsets.reserve(logo_count);
     
-    deflateEnd(&stream);
+    // Blobs start right after the table
+    table_.block_size = (2 + logo_count) * 4;
+    table_.header.size = table_.block_size;
+    
+    // Reserve room for header and table, patched in finish()
+    std::vector<uint8_t> placeholder;
+    LogoTable reserved = table_;
+    reserved.offsets.assign(logo_count, 0);
+    reserved.write(placeholder);
+    file_.write(reinterpret_cast<const char*>(placeholder.data()), placeholder.size());
+    
+    if (!file_) {
+        file_.close();
+        std::remove(temp_filename_.c_str());
+        throw MtkLogoException("Failed to write file: " + temp_filename_);
+    }
+}
+
+LogoImageWriter::~LogoImageWriter() {
+    if (!finished_) {
+        file_.close();
+        std::remove(temp_filename_.c_str());
+    }
+}
+
+void LogoImageWriter::append(const uint8_t* data, size_t size) {
+    if (table_.offsets.size() >= expected_count_) {
+        throw MtkLogoException("Too many blobs for logo table");
+    }
+    
+    if (static_cast<uint64_t>(table_.block_size) + size > UINT32_MAX) {
+        throw MtkLogoException("Logo image exceeds 4 GiB");
+    }
+    
+    table_.offsets.push_back(table_.block_size);
+    table_.block_size += size;
+    
+    file_.write(reinterpret_cast<const char*>(data), size);
+    if (!file_) {
+        throw MtkLogoException("Failed to write file: " + temp_filename_);
+    }
+}
+
+void LogoImageWriter::finish() {
+    if (table_.offsets.size() != expected_count_) {
+        throw MtkLogoException("Logo table expects " + std::to_string(expected_count_) +
+                               " blobs, got " + std::to_string(table_.offsets.size()));
+    }
+    
+    table_.header.size = table_.block_size;
+    
+    // Rewrite header and table now that the offsets are known
+    std::vector<uint8_t> buffer;
+    table_.write(buffer);
+    
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    file_.close();
+    
+    if (!file_) {
+        throw MtkLogoException("Failed to write file: " + temp_filename_);
+    }
+    
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(filename_.c_str());
+#endif
+    // A mapping of the old file stays valid, it keeps the replaced inode
+    if (std::rename(temp_filename_.c_str(), filename_.c_str()) != 0) {
+        throw MtkLogoException("Failed to replace file: " + filename_);
+    }
+    finished_ = true;
+}
+
+// ============================================================================
+// ImageUtils Implementation
+// ============================================================================
+
+std::vector<uint8_t> ImageUtils::zlibDecompress(const std::vector<uint8_t>& compressed) {
+    return zlibDecompress(compressed.data(), compressed.size());
+}
+
+std::vector<uint8_t> ImageUtils::zlibDecompress(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> decompressed;
+    CodecContext::forThread().inflate(bootmod::ByteSpan(data, size), decompressed);
+    return decompressed;
+}
+
+std::vector<uint8_t> ImageUtils::zlibCompress(const std::vector<uint8_t>& data, int level) {
+    std::vector<uint8_t> compressed;
+    CodecContext::forThread().deflate(data, compressed, level);
     return compressed;
 }
 
+size_t ImageUtils::decompressInto(bootmod::ByteSpan compressed, uint8_t* dst, size_t capacity) {
+    return CodecContext::forThread().inflateInto(compressed, dst, capacity);
+}
+
+size_t ImageUtils::inflatedSize(bootmod::ByteSpan compressed) {
+    return CodecContext::forThread().inflatedSize(compressed);
+}
+
+size_t ImageUtils::peekInflated(bootmod::ByteSpan compressed, uint8_t* dst, size_t count) {
+    return CodecContext::forThread().inflatePeek(compressed, dst, count);
+}
+
+size_t ImageUtils::compressInto(bootmod::ByteSpan data, uint8_t* dst, size_t capacity, int level) {
+    return CodecContext::forThread().deflateInto(data, dst, capacity, level);
+}
+
+uint64_t ImageUtils::hashBytes(bootmod::ByteSpan data) {
+    return bootmod::checksum::hash64(data);
+}
+
 uint32_t ImageUtils::getBytesPerPixel(ColorMode mode) {
     switch (mode) {
         case ColorMode::RGBA_BE:
@@ -1,114 +1,211 @@
 #include "bootmod.h"
+#include "checksum.h"
+#include "pixel_format.h"
+#include "profile.h"
+#include "project.h"
+#include "stats.h"
+#include "thread_pool.h"
 #include <png.h>
 #include <cstdio>
 #include <cstring>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 
 namespace mtklogo {
 
+// Helper: Progress text goes to stdout unless the caller collects it
+static void emit(std::string* log, const std::string& text) {
+    if (log) {
+        log->append(text);
+    } else {
+        fputs(text.c_str(), stdout);
+    }
+}
+
+// Helper: Errors go to stderr unless the caller collects them
+static void emitError(std::string* log, const char* message) {
+    if (log) {
+        bootmod::appendFormat(*log, "Error: %s\n", message);
+    } else {
+        fprintf(stderr, "Error: %s\n", message);
+    }
+}
+
 // ============================================================================
 // PNG I/O Implementation
 // ============================================================================
 
+// Helper: libpng output through stdio, timed as the write stage
+static void writePngData(png_structp png, png_bytep data, png_size_t length) {
+    bool written;
+    {
+        bootmod::StageTimer timer(bootmod::Stage::WRITE);
+        written = fwrite(data, 1, length, static_cast<FILE*>(png_get_io_ptr(png))) == length;
+    }
+    if (!written) {
+        png_error(png, "Write Error");
+    }
+    bootmod::countBytes(0, length);
+}
+
+static void flushPngData(png_structp png) {
+    bootmod::StageTimer timer(bootmod::Stage::WRITE);
+    fflush(static_cast<FILE*>(png_get_io_ptr(png)));
+}
+
+// Helper: libpng output into a vector
+static void appendPngData(png_structp png, png_bytep data, png_size_t length) {
+    std::vector<uint8_t>* out = static_cast<std::vector<uint8_t>*>(png_get_io_ptr(png));
+    out->insert(out->end(), data, data + length);
+}
+
+static void flushNothing(png_structp) {
+}
+
+// Helper: libpng input through stdio, timed as the read stage
+static void readPngData(png_structp png, png_bytep data, png_size_t length) {
+    size_t read;
+    {
+        bootmod::StageTimer timer(bootmod::Stage::READ);
+        read = fread(data, 1, length, static_cast<FILE*>(png_get_io_ptr(png)));
+    }
+    if (read != length) {
+        png_error(png, "Read Error");
+    }
+    bootmod::countBytes(length, 0);
+}
+
+// Helper: Have libpng expand whatever the file holds to 8-bit RGBA
+static void setRgbaTransforms(png_structp png, png_infop info) {
+    png_byte color_type = png_get_color_type(png, info);
+    png_byte bit_depth = png_get_bit_depth(png, info);
+    
+    if (bit_depth == 16) {
+        png_set_strip_16(png);
+    }
+    
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png);
+    }
+    
+    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png);
+    }
+    
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+        png_set_tRNS_to_alpha(png);
+    }
+    
+    if (color_type == PNG_COLOR_TYPE_RGB ||
+        color_type == PNG_COLOR_TYPE_GRAY ||
+        color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    }
+    
+    if (color_type == PNG_COLOR_TYPE_GRAY ||
+        color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_gray_to_rgb(png);
+    }
+}
+
 bool ImageUtils::saveToPNG(const std::string& filename, 
                           const std::vector<uint8_t>& pixels,
                           uint32_t width, 
                           uint32_t height,
                           ColorMode mode) {
-    FILE* fp = fopen(filename.c_str(), "wb");
-    if (!fp) {
+    size_t row_bytes = static_cast<size_t>(width) * getBytesPerPixel(mode);
+    if (pixels.size() < row_bytes * height) {
         return false;
     }
     
-    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-    if (!png) {
-        fclose(fp);
-        return false;
-    }
-    
-    png_infop info = png_create_info_struct(png);
-    if (!info) {
-        png_destroy_write_struct(&png, nullptr);
-        fclose(fp);
+    // Copied out one band at a time, only the band is converted to RGBA
+    try {
+        PngRowWriter writer(filename, width, height, mode);
+        for (uint32_t y = 0; y < height;) {
+            uint32_t rows = std::min(writer.bandRows(), height - y);
+            memcpy(writer.bandBuffer(), pixels.data() + y * row_bytes, rows * row_bytes);
+            writer.writeBand(rows);
+            y += rows;
+        }
+        writer.finish();
+        return true;
+    } catch (const std::exception&) {
         return false;
     }
-    
-    if (setjmp(png_jmpbuf(png))) {
-        png_destroy_write_struct(&png, &info);
-        fclose(fp);
-        return false;
+}
+
+size_t ImageUtils::measureFrame(bootmod::ByteSpan blob, std::vector<uint8_t>& frame) {
+    CodecContext& codec = CodecContext::forThread();
+    if (codec.streamsInflate()) {
+        frame.clear();
+        return codec.inflatedSize(blob);
     }
+    codec.inflate(blob, frame);
+    return frame.size();
+}
+
+// Helper: Feed a blob, or the frame measureFrame() already inflated, to a
+// PNG writer band by band
+static void writeFrame(PngRowWriter& writer, bootmod::ByteSpan blob, uint32_t height,
+                       const std::vector<uint8_t>& frame) {
+    size_t frame_size = static_cast<size_t>(height) * writer.rowBytes();
     
-    png_init_io(png, fp);
-    
-    // Convert to RGBA for PNG output
-    std::vector<uint8_t> rgba_pixels;
-    uint32_t bpp = getBytesPerPixel(mode);
-    
-    if (mode == ColorMode::RGBA_BE || mode == ColorMode::RGBA_LE) {
-        // Already RGBA, might need endian swap
-        rgba_pixels = pixels;
-        if (mode == ColorMode::RGBA_BE) {
-            // Swap endianness if needed
-            for (size_t i = 0; i < rgba_pixels.size(); i += 4) {
-                // For RGBA_BE, swap if needed (typically we want LE for PNG)
-            }
+    // Already inflated by a one-shot backend
+    if (!frame.empty()) {
+        if (frame.size() != frame_size) {
+            throw MtkLogoException(frame.size() < frame_size ? "Decompressed data is smaller than the image"
+                                                             : "Decompressed data is larger than the image");
         }
-    } else if (mode == ColorMode::BGRA_BE || mode == ColorMode::BGRA_LE) {
-        // Convert BGRA to RGBA
-        rgba_pixels.reserve(pixels.size());
-        for (size_t i = 0; i < pixels.size(); i += 4) {
-            rgba_pixels.push_back(pixels[i + 2]); // R
-            rgba_pixels.push_back(pixels[i + 1]); // G
-            rgba_pixels.push_back(pixels[i + 0]); // B
-            rgba_pixels.push_back(pixels[i + 3]); // A
-        }
-    } else if (mode == ColorMode::RGB565_BE || mode == ColorMode::RGB565_LE) {
-        // Convert RGB565 to RGBA
-        rgba_pixels.reserve(width * height * 4);
-        for (size_t i = 0; i < pixels.size(); i += 2) {
-            uint16_t pixel;
-            if (mode == ColorMode::RGB565_LE) {
-                pixel = pixels[i] | (pixels[i + 1] << 8);
-            } else {
-                pixel = (pixels[i] << 8) | pixels[i + 1];
-            }
-            
-            uint8_t r = ((pixel >> 11) & 0x1F) << 3;
-            uint8_t g = ((pixel >> 5) & 0x3F) << 2;
-            uint8_t b = (pixel & 0x1F) << 3;
-            
-            rgba_pixels.push_back(r);
-            rgba_pixels.push_back(g);
-            rgba_pixels.push_back(b);
-            rgba_pixels.push_back(255); // Full alpha
+        for (uint32_t y = 0; y < height;) {
+            uint32_t rows = std::min(writer.bandRows(), height - y);
+            memcpy(writer.bandBuffer(), frame.data() + y * writer.rowBytes(), rows * writer.rowBytes());
+            writer.writeBand(rows);
+            y += rows;
         }
+        writer.finish();
+        return;
     }
     
-    // Set PNG header
-    png_set_IHDR(png, info, width, height, 8,
-                 PNG_COLOR_TYPE_RGBA,
-                 PNG_INTERLACE_NONE,
-                 PNG_COMPRESSION_TYPE_DEFAULT,
-                 PNG_FILTER_TYPE_DEFAULT);
+    bootmod::InflateScope stream(CodecContext::forThread(), blob);
     
-    png_write_info(png, info);
-    
-    // Write image data
-    std::vector<png_bytep> row_pointers(height);
-    for (uint32_t y = 0; y < height; y++) {
-        row_pointers[y] = const_cast<png_bytep>(&rgba_pixels[y * width * 4]);
+    for (uint32_t y = 0; y < height;) {
+        uint32_t rows = std::min(writer.bandRows(), height - y);
+        size_t band_size = rows * writer.rowBytes();
+        if (stream.read(writer.bandBuffer(), band_size) != band_size) {
+            throw MtkLogoException("Decompressed data is smaller than the image");
+        }
+        writer.writeBand(rows);
+        y += rows;
     }
     
-    png_write_image(png, row_pointers.data());
-    png_write_end(png, nullptr);
-    
-    png_destroy_write_struct(&png, &info);
-    fclose(fp);
-    
-    return true;
+    uint8_t extra;
+    if (stream.read(&extra, 1) != 0) {
+        throw MtkLogoException("Decompressed data is larger than the image");
+    }
+    writer.finish();
+}
+
+void ImageUtils::inflateToPNG(bootmod::ByteSpan blob,
+                              const std::string& filename,
+                              uint32_t width,
+                              uint32_t height,
+                              ColorMode mode,
+                              const std::vector<uint8_t>& frame) {
+    PngRowWriter writer(filename, width, height, mode);
+    writeFrame(writer, blob, height, frame);
+}
+
+void ImageUtils::inflateToPNG(bootmod::ByteSpan blob,
+                              std::vector<uint8_t>& png,
+                              uint32_t width,
+                              uint32_t height,
+                              ColorMode mode,
+                              const std::vector<uint8_t>& frame) {
+    PngRowWriter writer(png, width, height, mode);
+    writeFrame(writer, blob, height, frame);
 }
 
 std::vector<uint8_t> ImageUtils::loadFromPNG(const std::string& filename,
@@ -144,37 +241,7 @@ std::vector<uint8_t> ImageUtils::loadFromPNG(const std::string& filename,
     
     width = png_get_image_width(png, info);
     height = png_get_image_height(png, info);
-    png_byte color_type = png_get_color_type(png, info);
-    png_byte bit_depth = png_get_bit_depth(png, info);
-    
-    // Convert to RGBA
-    if (bit_depth == 16) {
-        png_set_strip_16(png);
-    }
-    
-    if (color_type == PNG_COLOR_TYPE_PALETTE) {
-        png_set_palette_to_rgb(png);
-    }
-    
-    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
-        png_set_expand_gray_1_2_4_to_8(png);
-    }
-    
-    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
-        png_set_tRNS_to_alpha(png);
-    }
-    
-    if (color_type == PNG_COLOR_TYPE_RGB ||
-        color_type == PNG_COLOR_TYPE_GRAY ||
-        color_type == PNG_COLOR_TYPE_PALETTE) {
-        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
-    }
-    
-    if (color_type == PNG_COLOR_TYPE_GRAY ||
-        color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
-        png_set_gray_to_rgb(png);
-    }
-    
+    setRgbaTransforms(png, info);
     png_read_update_info(png, info);
     
     // Read image data
@@ -189,8 +256,9 @@ std::vector<uint8_t> ImageUtils::loadFromPNG(const std::string& filename,
     png_destroy_read_struct(&png, &info, nullptr);
     fclose(fp);
     
-    // Convert RGBA to target color mode
-    return convertColorMode(rgba_data, ColorMode::RGBA_LE, mode);
+    // libpng hands back R, G, B, A bytes, convert to the target without reallocating
+    convertColorModeInPlace(rgba_data, ColorMode::RGBA_BE, mode);
+    return rgba_data;
 }
 
 std::vector<uint8_t> ImageUtils::convertColorMode(const std::vector<uint8_t>& pixels,
@@ -200,141 +268,943 @@ std::vector<uint8_t> ImageUtils::convertColorMode(const std::vector<uint8_t>& pi
         return pixels;
     }
     
-    // For now, assume input is RGBA_LE and convert to target
-    std::vector<uint8_t> output;
-    
-    if (to == ColorMode::BGRA_BE || to == ColorMode::BGRA_LE) {
-        // Convert RGBA to BGRA
-        output.reserve(pixels.size());
-        for (size_t i = 0; i < pixels.size(); i += 4) {
-            output.push_back(pixels[i + 2]); // B
-            output.push_back(pixels[i + 1]); // G
-            output.push_back(pixels[i + 0]); // R
-            output.push_back(pixels[i + 3]); // A
-        }
-    } else if (to == ColorMode::RGB565_BE || to == ColorMode::RGB565_LE) {
-        // Convert RGBA to RGB565
-        output.reserve(pixels.size() / 2);
-        for (size_t i = 0; i < pixels.size(); i += 4) {
-            uint8_t r = pixels[i] >> 3;
-            uint8_t g = pixels[i + 1] >> 2;
-            uint8_t b = pixels[i + 2] >> 3;
-            
-            uint16_t pixel = (r << 11) | (g << 5) | b;
-            
-            if (to == ColorMode::RGB565_LE) {
-                output.push_back(pixel & 0xFF);
-                output.push_back(pixel >> 8);
-            } else {
-                output.push_back(pixel >> 8);
-                output.push_back(pixel & 0xFF);
+    size_t pixel_count = pixels.size() / getBytesPerPixel(from);
+    std::vector<uint8_t> output(pixel_count * getBytesPerPixel(to));
+    getPixelConverter(from, to)(pixels.data(), output.data(), pixel_count);
+    return output;
+}
+
+void ImageUtils::convertColorModeInPlace(std::vector<uint8_t>& pixels,
+                                         ColorMode from,
+                                         ColorMode to) {
+    if (from == to) {
+        return;
+    }
+    
+    uint32_t from_bpp = getBytesPerPixel(from);
+    uint32_t to_bpp = getBytesPerPixel(to);
+    size_t pixel_count = pixels.size() / from_bpp;
+    
+    // Growing needs the room up front, shrinking trims afterwards
+    if (to_bpp > from_bpp) {
+        pixels.resize(pixel_count * to_bpp);
+    }
+    getInPlacePixelConverter(from, to)(pixels.data(), pixel_count);
+    pixels.resize(pixel_count * to_bpp);
+}
+
+// ============================================================================
+// PNG Row Streaming
+// ============================================================================
+
+struct PngRowReader::State {
+    FILE* fp;
+    png_structp png;
+    png_infop info;
+    std::vector<uint8_t> band;   // RGBA rows, converted in place
+    std::vector<uint8_t> image;  // Whole frame, interlaced files only
+    std::vector<png_bytep> rows; // Row pointers into image while it is read
+    PixelConvertInPlaceFn convert;
+    
+    State() : fp(nullptr), png(nullptr), info(nullptr), convert(nullptr) {}
+    
+    ~State() {
+        if (png) {
+            png_destroy_read_struct(&png, info ? &info : nullptr, nullptr);
+        }
+        if (fp) {
+            fclose(fp);
+        }
+    }
+};
+
+PngRowReader::PngRowReader(const std::string& filename, ColorMode mode)
+    : state_(new State()), width_(0), height_(0),
+      row_bytes_(0), band_rows_(0), next_row_(0) {
+    State& st = *state_;
+    
+    {
+        bootmod::StageTimer timer(bootmod::Stage::READ);
+        st.fp = fopen(filename.c_str(), "rb");
+    }
+    if (!st.fp) {
+        throw MtkLogoException("Cannot open PNG file: " + filename);
+    }
+    
+    bootmod::StageTimer timer(bootmod::Stage::PNG_DECODE);
+    st.png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!st.png) {
+        throw MtkLogoException("Failed to create PNG read struct");
+    }
+    
+    st.info = png_create_info_struct(st.png);
+    if (!st.info) {
+        throw MtkLogoException("Failed to create PNG info struct");
+    }
+    
+    if (setjmp(png_jmpbuf(st.png))) {
+        throw MtkLogoException("Error reading PNG file: " + filename);
+    }
+    
+    png_set_read_fn(st.png, st.fp, readPngData);
+    png_read_info(st.png, st.info);
+    
+    width_ = png_get_image_width(st.png, st.info);
+    height_ = png_get_image_height(st.png, st.info);
+    setRgbaTransforms(st.png, st.info);
+    int passes = png_set_interlace_handling(st.png);
+    png_read_update_info(st.png, st.info);
+    
+    row_bytes_ = width_ * ImageUtils::getBytesPerPixel(mode);
+    st.convert = getInPlacePixelConverter(ColorMode::RGBA_BE, mode);
+    
+    // Bands of about 64 KiB of RGBA
+    const size_t BAND_BYTES = 65536;
+    size_t rgba_row = static_cast<size_t>(width_) * 4;
+    band_rows_ = static_cast<uint32_t>(std::max<size_t>(1, BAND_BYTES / rgba_row));
+    
+    if (passes > 1) {
+        // Row pointers live in the state, a libpng error longjmps past locals
+        st.image.resize(rgba_row * height_);
+        st.rows.resize(height_);
+        for (uint32_t y = 0; y < height_; y++) {
+            st.rows[y] = &st.image[y * rgba_row];
+        }
+        png_read_image(st.png, st.rows.data());
+        std::vector<png_bytep>().swap(st.rows);
+    } else {
+        st.band.resize(rgba_row * band_rows_);
+    }
+}
+
+PngRowReader::~PngRowReader() {
+}
+
+// Helper: Decode rows into band. Kept out of readBand so that no local
+// changed after setjmp is used once a libpng error longjmps back.
+static void readPngRows(png_structp png, uint8_t* band, uint32_t rows, size_t row_size) {
+    if (setjmp(png_jmpbuf(png))) {
+        throw MtkLogoException("Error reading PNG file");
+    }
+    for (uint32_t y = 0; y < rows; y++) {
+        png_read_row(png, band + y * row_size, nullptr);
+    }
+}
+
+bootmod::ByteSpan PngRowReader::readBand() {
+    if (next_row_ >= height_) {
+        return bootmod::ByteSpan();
+    }
+    
+    State& st = *state_;
+    size_t rgba_row = static_cast<size_t>(width_) * 4;
+    uint32_t rows = std::min(band_rows_, height_ - next_row_);
+    uint8_t* band;
+    
+    if (!st.image.empty()) {
+        band = &st.image[next_row_ * rgba_row];
+    } else {
+        band = st.band.data();
+        bootmod::StageTimer timer(bootmod::Stage::PNG_DECODE);
+        readPngRows(st.png, band, rows, rgba_row);
+    }
+    next_row_ += rows;
+    
+    size_t pixel_count = static_cast<size_t>(rows) * width_;
+    bootmod::StageTimer timer(bootmod::Stage::CONVERT);
+    st.convert(band, pixel_count);
+    return bootmod::ByteSpan(band, static_cast<size_t>(rows) * row_bytes_);
+}
+
+struct PngRowWriter::State {
+    std::string filename;
+    FILE* fp;
+    png_structp png;
+    png_infop info;
+    std::vector<uint8_t> band;   // Sized for RGBA, filled in the source mode
+    PixelConvertInPlaceFn convert;
+    bool finished;
+    
+    State() : fp(nullptr), png(nullptr), info(nullptr), convert(nullptr), finished(false) {}
+    
+    ~State() {
+        if (png) {
+            png_destroy_write_struct(&png, info ? &info : nullptr);
+        }
+        if (fp) {
+            fclose(fp);
+            if (!finished) {
+                remove(filename.c_str());
             }
         }
+    }
+};
+
+PngRowWriter::PngRowWriter(const std::string& filename, uint32_t width, uint32_t height,
+                           ColorMode mode)
+    : state_(new State()), width_(width), height_(height),
+      row_bytes_(width * ImageUtils::getBytesPerPixel(mode)), band_rows_(0), next_row_(0) {
+    State& st = *state_;
+    st.filename = filename;
+    
+    {
+        bootmod::StageTimer timer(bootmod::Stage::WRITE);
+        st.fp = fopen(filename.c_str(), "wb");
+    }
+    if (!st.fp) {
+        throw MtkLogoException("Cannot create PNG file: " + filename);
+    }
+    
+    start(mode, st.fp);
+}
+
+PngRowWriter::PngRowWriter(std::vector<uint8_t>& out, uint32_t width, uint32_t height, ColorMode mode)
+    : state_(new State()), width_(width), height_(height),
+      row_bytes_(width * ImageUtils::getBytesPerPixel(mode)), band_rows_(0), next_row_(0) {
+    state_->filename = "PNG in memory";
+    out.clear();
+    start(mode, &out);
+}
+
+void PngRowWriter::start(ColorMode mode, void* io) {
+    State& st = *state_;
+    bootmod::StageTimer timer(bootmod::Stage::PNG_ENCODE);
+    st.png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!st.png) {
+        throw MtkLogoException("Failed to create PNG write struct");
+    }
+    
+    st.info = png_create_info_struct(st.png);
+    if (!st.info) {
+        throw MtkLogoException("Failed to create PNG info struct");
+    }
+    
+    if (setjmp(png_jmpbuf(st.png))) {
+        throw MtkLogoException("Error writing PNG file: " + st.filename);
+    }
+    
+    if (st.fp) {
+        png_set_write_fn(st.png, io, writePngData, flushPngData);
     } else {
-        // RGBA_BE or RGBA_LE
-        output = pixels;
+        png_set_write_fn(st.png, io, appendPngData, flushNothing);
     }
+    png_set_IHDR(st.png, st.info, width_, height_, 8,
+                 PNG_COLOR_TYPE_RGBA,
+                 PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(st.png, st.info);
     
-    return output;
+    st.convert = getInPlacePixelConverter(mode, ColorMode::RGBA_BE);
+    
+    // Bands of about 64 KiB of RGBA
+    const size_t BAND_BYTES = 65536;
+    size_t rgba_row = static_cast<size_t>(width_) * 4;
+    band_rows_ = static_cast<uint32_t>(std::max<size_t>(1, BAND_BYTES / rgba_row));
+    st.band.resize(rgba_row * band_rows_);
+}
+
+PngRowWriter::~PngRowWriter() {
+}
+
+uint8_t* PngRowWriter::bandBuffer() {
+    return state_->band.data();
+}
+
+void PngRowWriter::writeBand(uint32_t rows) {
+    State& st = *state_;
+    if (rows > band_rows_ || rows > height_ - next_row_) {
+        throw MtkLogoException("PNG band exceeds the image height");
+    }
+    
+    size_t rgba_row = static_cast<size_t>(width_) * 4;
+    {
+        bootmod::StageTimer timer(bootmod::Stage::CONVERT);
+        st.convert(st.band.data(), static_cast<size_t>(rows) * width_);
+    }
+    
+    bootmod::StageTimer timer(bootmod::Stage::PNG_ENCODE);
+    if (setjmp(png_jmpbuf(st.png))) {
+        throw MtkLogoException("Error writing PNG file: " + st.filename);
+    }
+    for (uint32_t y = 0; y < rows; y++) {
+        png_write_row(st.png, st.band.data() + y * rgba_row);
+    }
+    next_row_ += rows;
+}
+
+void PngRowWriter::finish() {
+    State& st = *state_;
+    if (next_row_ != height_) {
+        throw MtkLogoException("PNG is missing rows: " + st.filename);
+    }
+    
+    bootmod::StageTimer timer(bootmod::Stage::PNG_ENCODE);
+    if (setjmp(png_jmpbuf(st.png))) {
+        throw MtkLogoException("Error writing PNG file: " + st.filename);
+    }
+    png_write_end(st.png, nullptr);
+    st.finished = true;
 }
 
 // ============================================================================
 // MtkLogo Main Operations
 // ============================================================================
 
+// Progress output, written PNG (empty if saved raw) and stats of one unpacked slot
+struct UnpackSlot {
+    std::string log;
+    std::string png;
+    bootmod::SlotStats stats;
+};
+
+// Helper: Save a blob as it is stored, as a .z file
+static void saveRaw(const std::string& output_path, bootmod::ByteSpan blob) {
+    bootmod::StageTimer timer(bootmod::Stage::WRITE);
+    std::ofstream out(output_path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(blob.data), blob.size);
+    if (!out) {
+        throw MtkLogoException("Failed to write file: " + output_path);
+    }
+    bootmod::countBytes(0, blob.size);
+}
+
+// Helper: Save a slot as PNG if its frame size gives the dimensions, else
+// raw. frame is the slot's pixels if measureFrame() already inflated them.
+static void saveSlot(size_t id, bootmod::ByteSpan blob, size_t decompressed_size,
+                     const std::vector<uint8_t>& frame, const std::string& output_dir,
+                     ColorMode mode, const DeviceProfile* profile, UnpackSlot& slot) {
+    std::string& log = slot.log;
+    FileInfo file_info;
+    file_info.id = id;
+    
+    // The device profile decides when it knows the size, otherwise guess
+    Dimensions dimensions;
+    bool from_profile = profile && profile->dimensionsFor(id, decompressed_size, mode, dimensions);
+    bool known = from_profile;
+    if (!known) {
+        auto guesses = MtkLogo::guessDimensions(decompressed_size, mode);
+        if (!guesses.empty()) {
+            dimensions = guesses[0];
+            known = true;
+        }
+    }
+    
+    if (!known) {
+        bootmod::appendFormat(log, "  Could not determine dimensions, saving as raw\n");
+        file_info.is_compressed = true;
+        slot.stats.file = output_dir + "/" + file_info.getFilename();
+        saveRaw(slot.stats.file, blob);
+        return;
+    }
+    
+    uint32_t width = dimensions.first;
+    uint32_t height = dimensions.second;
+    if (from_profile) {
+        bootmod::appendFormat(log, "  Dimensions: %ux%u (profile %s)\n", width, height,
+                     profile->name().c_str());
+    } else {
+        bootmod::appendFormat(log, "  Dimensions: %ux%u\n", width, height);
+    }
+    
+    file_info.is_compressed = false;
+    file_info.color_mode = mode;
+    slot.stats.file = output_dir + "/" + file_info.getFilename();
+    slot.stats.width = width;
+    slot.stats.height = height;
+    
+    ImageUtils::inflateToPNG(blob, slot.stats.file, width, height, mode, frame);
+    bootmod::appendFormat(log, "  Saved: %s\n", slot.stats.file.c_str());
+    slot.png = file_info.getFilename();
+}
+
+// Helper: Extract one logo slot. With track, its work is timed into
+// slot.stats instead of the caller's scope. A file that cannot be written
+// is reported in slot.stats.error, the other slots still go ahead.
+static UnpackSlot unpackSlot(size_t id,
+                             bootmod::ByteSpan blob,
+                             const std::string& output_dir,
+                             ColorMode mode,
+                             bool extract_raw,
+                             const DeviceProfile* profile,
+                             bool track) {
+    UnpackSlot slot;
+    bootmod::StatsScope scope(track ? &slot.stats.stages : bootmod::StatsScope::current());
+    bootmod::countBytes(blob.size, 0);
+    slot.stats.index = id;
+    slot.stats.stored_bytes = blob.size;
+    
+    std::string& log = slot.log;
+    bootmod::appendFormat(log, "\nProcessing logo %zu: %zu bytes\n", id, blob.size);
+    
+    FileInfo file_info;
+    file_info.id = id;
+    file_info.is_compressed = true;
+    std::string raw_path = output_dir + "/" + file_info.getFilename();
+    
+    try {
+        if (extract_raw) {
+            // Save as raw .z file
+            slot.stats.file = raw_path;
+            saveRaw(raw_path, blob);
+            bootmod::appendFormat(log, "  Saved: %s\n", raw_path.c_str());
+            return slot;
+        }
+        
+        // Size the frame first, the PNG pass needs its dimensions up front
+        std::vector<uint8_t> frame;
+        size_t decompressed_size = 0;
+        bool inflates = true;
+        try {
+            decompressed_size = ImageUtils::measureFrame(blob, frame);
+        } catch (const std::exception&) {
+            inflates = false;
+        }
+        
+        if (inflates) {
+            slot.stats.frame_bytes = decompressed_size;
+            bootmod::appendFormat(log, "  Decompressed: %zu bytes\n", decompressed_size);
+            saveSlot(id, blob, decompressed_size, frame, output_dir, mode, profile, slot);
+        } else {
+            bootmod::appendFormat(log, "  Not compressed or decompression failed, saving as raw\n");
+            slot.stats.file = raw_path;
+            saveRaw(raw_path, blob);
+        }
+    } catch (const std::exception& e) {
+        slot.stats.error = e.what();
+    }
+    
+    return slot;
+}
+
 bool MtkLogo::unpack(const std::string& logo_file,
                     const std::string& output_dir,
                     ColorMode mode,
                     const std::vector<size_t>& slots,
                     bool extract_raw,
-                    bool flip) {
+                    bool flip,
+                    size_t jobs,
+                    const DeviceProfile* profile) {
+    UnpackOptions options;
+    options.mode = mode;
+    options.slots = slots;
+    options.extract_raw = extract_raw;
+    options.flip = flip;
+    options.jobs = jobs;
+    options.profile = profile;
+    return unpack(logo_file, output_dir, options);
+}
+
+bool MtkLogo::unpack(const std::string& logo_file,
+                    const std::string& output_dir,
+                    const UnpackOptions& options) {
     try {
-        // Read logo image
-        LogoImage image = LogoImage::readFromFile(logo_file);
+        // Map logo image, blobs are read straight from the mapping
+        LogoImageView image = LogoImageView::open(logo_file);
         
-        printf("Logo file: %s\n", logo_file.c_str());
-        printf("Number of logos: %zu\n", image.getLogoCount());
-        printf("Block size: %u bytes\n", image.table.block_size);
+        std::string header;
+        bootmod::appendFormat(header, "Logo file: %s\n", logo_file.c_str());
+        bootmod::appendFormat(header, "Number of logos: %zu\n", image.getLogoCount());
+        bootmod::appendFormat(header, "Block size: %u bytes\n", image.table.block_size);
+        if (options.profile) {
+            bootmod::appendFormat(header, "Device profile: %s\n", options.profile->name().c_str());
+        }
+        emit(options.log, header);
         
-        // Process each logo
+        // Select slots to extract (slots are 1-based from user input)
+        const std::vector<size_t>& slots = options.slots;
+        std::vector<size_t> selected;
         for (size_t i = 0; i < image.getLogoCount(); i++) {
-            // Check if we should extract this slot (slots are 1-based from user input)
-            if (!slots.empty()) {
-                if (std::find(slots.begin(), slots.end(), i + 1) == slots.end()) {
-                    continue;
-                }
+            if (slots.empty() || std::find(slots.begin(), slots.end(), i + 1) != slots.end()) {
+                selected.push_back(i);
             }
-            
-            const auto& blob = image.blobs[i];
-            printf("\nProcessing logo %zu: %zu bytes\n", i + 1, blob.size());
-            
-            FileInfo file_info;
-            file_info.id = i + 1;
-            
-            if (extract_raw) {
-                // Save as raw .z file
-                file_info.is_compressed = true;
-                std::string output_path = output_dir + "/" + file_info.getFilename();
-                
-                std::ofstream out(output_path, std::ios::binary);
-                out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
-                printf("  Saved: %s\n", output_path.c_str());
-            } else {
-                // Try to decompress and save as PNG
-                try {
-                    std::vector<uint8_t> decompressed = ImageUtils::zlibDecompress(blob);
-                    printf("  Decompressed: %zu bytes\n", decompressed.size());
-                    
-                    // Try to guess dimensions
-                    uint32_t bpp = ImageUtils::getBytesPerPixel(mode);
-                    auto dimensions = guessDimensions(decompressed.size(), mode);
-                    
-                    if (!dimensions.empty()) {
-                        uint32_t width = dimensions[0].first;
-                        uint32_t height = dimensions[0].second;
-                        
-                        printf("  Dimensions: %ux%u\n", width, height);
-                        
-                        file_info.is_compressed = false;
-                        file_info.color_mode = mode;
-                        std::string output_path = output_dir + "/" + file_info.getFilename();
-                        
-                        if (ImageUtils::saveToPNG(output_path, decompressed, width, height, mode)) {
-                            printf("  Saved: %s\n", output_path.c_str());
-                        } else {
-                            printf("  Failed to save PNG\n");
-                        }
-                    } else {
-                        printf("  Could not determine dimensions, saving as raw\n");
-                        file_info.is_compressed = true;
-                        std::string output_path = output_dir + "/" + file_info.getFilename();
-                        
-                        std::ofstream out(output_path, std::ios::binary);
-                        out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
-                    }
-                } catch (const std::exception& e) {
-                    printf("  Not compressed or decompression failed, saving as raw\n");
-                    file_info.is_compressed = true;
-                    std::string output_path = output_dir + "/" + file_info.getFilename();
-                    
-                    std::ofstream out(output_path, std::ios::binary);
-                    out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        }
+        
+        // Slots are inflated and PNG-encoded concurrently, output stays in slot order
+        std::unique_ptr<bootmod::ThreadPool> own_pool;
+        bootmod::ThreadPool* pool = options.pool;
+        size_t jobs = options.jobs;
+        if (jobs == 0) {
+            jobs = bootmod::ThreadPool::defaultThreadCount();
+        }
+        if (!pool && jobs > 1) {
+            own_pool.reset(new bootmod::ThreadPool(jobs));
+            pool = own_pool.get();
+        }
+        
+        // Written PNGs are recorded so repack can reuse unchanged slots
+        ProjectManifest manifest;
+        size_t failed = 0;
+        
+        bootmod::orderedParallelFor<UnpackSlot>(pool, selected.size(),
+            [&](size_t n) {
+                size_t i = selected[n];
+                return unpackSlot(i + 1, image.blob(i), output_dir, options.mode, options.extract_raw,
+                                  options.profile, options.stats != nullptr);
+            },
+            [&](size_t n, UnpackSlot& slot) {
+                emit(options.log, slot.log);
+                if (!slot.stats.error.empty()) {
+                    std::string message;
+                    bootmod::appendFormat(message, "Logo %zu: %s", slot.stats.index, slot.stats.error.c_str());
+                    emitError(options.log, message.c_str());
+                    failed++;
                 }
-            }
+                if (options.stats) {
+                    options.stats->push_back(slot.stats);
+                }
+                if (!slot.png.empty()) {
+                    manifest.add(output_dir, selected[n] + 1, options.mode, slot.png);
+                }
+            });
+        
+        if (!manifest.entries.empty()) {
+            bootmod::StageTimer timer(bootmod::Stage::WRITE);
+            manifest.save(output_dir, logo_file);
+            std::string footer;
+            bootmod::appendFormat(footer, "\nManifest: %s/%s\n", output_dir.c_str(), ProjectManifest::MANIFEST_NAME);
+            emit(options.log, footer);
         }
         
+        if (failed > 0) {
+            std::string message;
+            bootmod::appendFormat(message, "%zu of %zu slots could not be saved", failed, selected.size());
+            emitError(options.log, message.c_str());
+            return false;
+        }
         return true;
     } catch (const std::exception& e) {
-        fprintf(stderr, "Error: %s\n", e.what());
+        emitError(options.log, e.what());
+        return false;
+    }
+}
+
+// Helper: Blob starts with a valid zlib header (RFC 1950): deflate with a
+// window of at most 32K, no preset dictionary, header check bits correct.
+// Any compression level passes, e.g. 78 5E written for levels 2 to 5.
+static bool isZlibBlob(bootmod::ByteSpan blob) {
+    if (blob.size < 2) {
+        return false;
+    }
+    unsigned cmf = blob[0];
+    unsigned flg = blob[1];
+    return (cmf & 0x0F) == 8 && (cmf >> 4) <= 7 && (flg & 0x20) == 0 &&
+           ((cmf << 8) | flg) % 31 == 0;
+}
+
+std::vector<LogoSlotInfo> MtkLogo::describe(const LogoImageView& image,
+                                            bool measure,
+                                            bootmod::ThreadPool* pool) {
+    std::vector<LogoSlotInfo> slots(image.getLogoCount());
+    
+    for (size_t i = 0; i < slots.size(); i++) {
+        bootmod::ByteSpan blob = image.blob(i);
+        LogoSlotInfo& slot = slots[i];
+        slot.offset = MtkHeader::SIZE + static_cast<size_t>(image.table.offsets[i]);
+        slot.size = static_cast<uint32_t>(blob.size);
+        slot.zlib = isZlibBlob(blob);
+    }
+    
+    if (!measure) {
+        return slots;
+    }
+    
+    // Only the blob pages are touched, each worker inflates into its own window
+    bootmod::orderedParallelFor<size_t>(pool, slots.size(),
+        [&](size_t i) -> size_t {
+            if (!slots[i].zlib) {
+                return 0;
+            }
+            try {
+                bootmod::ByteSpan blob = image.blob(i);
+                bootmod::countBytes(blob.size, 0);
+                return ImageUtils::inflatedSize(blob);
+            } catch (const std::exception&) {
+                slots[i].corrupt = true;
+                return 0;
+            }
+        },
+        [&](size_t i, size_t& decompressed_size) {
+            slots[i].measured = slots[i].zlib;
+            slots[i].decompressed_size = decompressed_size;
+        });
+    
+    return slots;
+}
+
+std::vector<LogoSlotCheck> MtkLogo::verify(const std::string& logo_file,
+                                           const DeviceProfile* profile,
+                                           bootmod::ThreadPool* pool) {
+    bootmod::MappedFile file;
+    if (!file.open(logo_file)) {
+        throw MtkLogoException("Cannot open file: " + logo_file);
+    }
+    
+    LogoTable table = LogoTable::read(file.data(), file.size());
+    if (!profile) {
+        profile = &ProfileDatabase::generic();
+    }
+    
+    // Offsets count from the end of the MTK header, where the table starts
+    size_t blob_area = file.size() - MtkHeader::SIZE;
+    size_t table_end = 8 + static_cast<size_t>(table.logo_count) * 4;
+    
+    // Table checks first, LogoImageView::open() would throw on the first bad entry
+    std::vector<LogoSlotCheck> checks(table.logo_count);
+    std::vector<bootmod::ByteSpan> blobs(table.logo_count);
+    for (size_t i = 0; i < checks.size(); i++) {
+        LogoSlotCheck& check = checks[i];
+        size_t start = table.offsets[i];
+        size_t end = (i + 1 < checks.size()) ? table.offsets[i + 1] : table.block_size;
+        check.offset = MtkHeader::SIZE + start;
+        
+        if (start < table_end) {
+            bootmod::appendFormat(check.error, "offset 0x%zx lies inside the logo table", start);
+        } else if (end < start && i + 1 < checks.size()) {
+            bootmod::appendFormat(check.error, "next offset 0x%zx is below this one (table not increasing)", end);
+        } else if (end < start) {
+            bootmod::appendFormat(check.error, "offset 0x%zx is past the block size 0x%zx", start, end);
+        } else if (end > blob_area) {
+            bootmod::appendFormat(check.error, "blob ends %zu bytes past the end of the file", end - blob_area);
+        } else {
+            check.size = static_cast<uint32_t>(end - start);
+            blobs[i] = bootmod::ByteSpan(file.data() + MtkHeader::SIZE + start, check.size);
+        }
+    }
+    
+    // Every blob inflates in full, zlib verifies its Adler-32 on the way
+    bootmod::orderedParallelFor<LogoSlotCheck>(pool, checks.size(),
+        [&](size_t i) -> LogoSlotCheck {
+            LogoSlotCheck check = checks[i];
+            if (!check.error.empty()) {
+                return check;
+            }
+            if (!isZlibBlob(blobs[i])) {
+                check.error = "not a zlib stream";
+                return check;
+            }
+            
+            try {
+                check.decompressed_size = ImageUtils::inflatedSize(blobs[i]);
+            } catch (const std::exception& e) {
+                check.error = std::string("inflate failed: ") + e.what();
+                return check;
+            }
+            
+            Dimensions dims;
+            if (!profile->dimensionsFor(i + 1, check.decompressed_size, ColorMode::BGRA_BE, dims) &&
+                !profile->dimensionsFor(i + 1, check.decompressed_size, ColorMode::RGB565_LE, dims)) {
+                bootmod::appendFormat(check.warning, "%zu bytes match no resolution of profile %s",
+                             check.decompressed_size, profile->name().c_str());
+            }
+            return check;
+        },
+        [&](size_t i, LogoSlotCheck& check) {
+            checks[i] = std::move(check);
+        });
+    
+    return checks;
+}
+
+// Compression settings tried by --target-size, cheapest first
+struct CompressionStep {
+    int level;
+    bootmod::DeflateStrategy strategy;
+    const char* name;
+};
+
+static const CompressionStep COMPRESSION_LADDER[] = {
+    {1, bootmod::DeflateStrategy::DEFAULT, "level 1"},
+    {3, bootmod::DeflateStrategy::DEFAULT, "level 3"},
+    {6, bootmod::DeflateStrategy::DEFAULT, "level 6"},
+    {9, bootmod::DeflateStrategy::DEFAULT, "level 9"},
+    {9, bootmod::DeflateStrategy::FILTERED, "level 9 filtered"}
+};
+
+static const size_t COMPRESSION_STEPS = sizeof(COMPRESSION_LADDER) / sizeof(COMPRESSION_LADDER[0]);
+static const size_t DEFAULT_COMPRESSION_STEP = 3;  // Level 9, used without --target-size
+
+// One repacked slot, from PNG to compressed blob. Pixels are never held,
+// every pass streams the PNG again in bands.
+struct RepackSlot {
+    std::vector<uint8_t> blob;
+    std::string log;
+    
+    std::string file;             // Source PNG
+    ColorMode mode;               // Mode the PNG is converted to
+    uint32_t width;
+    uint32_t height;
+    uint64_t hash;                // Of the converted pixels, taken while compressing
+    size_t source;                // Slot whose blob this one reuses (itself if unique)
+    size_t uses;                  // Slots sharing this blob (unique slots only)
+    size_t step;                  // Last COMPRESSION_LADDER step tried
+    size_t blob_step;             // Step the kept blob was compressed at
+    bool is_raw;                  // Pre-compressed .z input, never recompressed
+    bool reused;                  // Original blob taken from the unpack manifest
+    bool tracked;                 // Work is timed into stats, not the caller's scope
+    bootmod::SlotStats stats;
+};
+
+// Helper: Stats the work on a slot is timed into
+static bootmod::StageStats* slotTiming(RepackSlot& slot) {
+    return slot.tracked ? &slot.stats.stages : bootmod::StatsScope::current();
+}
+
+// Helper: Load one input file. PNGs are not opened yet, the first compression
+// pass decodes them. Images unchanged since unpack take their original blob
+// from the manifest.
+static RepackSlot loadSlot(size_t id, const std::string& file, const ProjectManifest* manifest,
+                           bool track) {
+    RepackSlot slot;
+    slot.mode = ColorMode::BGRA_BE;
+    slot.width = 0;
+    slot.height = 0;
+    slot.hash = 0;
+    slot.uses = 1;
+    slot.step = DEFAULT_COMPRESSION_STEP;
+    slot.blob_step = DEFAULT_COMPRESSION_STEP;
+    slot.is_raw = false;
+    slot.reused = false;
+    slot.tracked = track;
+    slot.stats.index = id;
+    slot.stats.file = file;
+    bootmod::StatsScope scope(slotTiming(slot));
+    bootmod::appendFormat(slot.log, "Processing file %zu: %s\n", id, file.c_str());
+    
+    size_t last_slash = file.find_last_of("/\\");
+    std::string filename = (last_slash != std::string::npos) ? 
+                          file.substr(last_slash + 1) : file;
+    
+    FileInfo info = FileInfo::fromFilename(filename);
+    const ManifestEntry* unchanged = nullptr;
+    if (manifest && !info.is_compressed) {
+        // Hashes the whole image file
+        bootmod::StageTimer timer(bootmod::Stage::HASH);
+        unchanged = manifest->findUnchanged(file);
+    }
+    
+    if (unchanged) {
+        // Original blob, copied verbatim
+        {
+            bootmod::StageTimer timer(bootmod::Stage::READ);
+            bootmod::ByteSpan original = manifest->originalBlob(*unchanged);
+            slot.blob.assign(original.begin(), original.end());
+        }
+        bootmod::countBytes(slot.blob.size(), 0);
+        slot.is_raw = true;
+        slot.reused = true;
+        bootmod::appendFormat(slot.log, "  Unchanged since unpack, reusing original blob: %zu bytes\n",
+                     slot.blob.size());
+    } else if (info.is_compressed) {
+        // Read raw file
+        {
+            bootmod::StageTimer timer(bootmod::Stage::READ);
+            std::ifstream in(file, std::ios::binary);
+            slot.blob.assign(std::istreambuf_iterator<char>(in),
+                             std::istreambuf_iterator<char>());
+        }
+        bootmod::countBytes(slot.blob.size(), 0);
+        slot.is_raw = true;
+    } else {
+        // Decoded, hashed and measured by the first compression pass
+        slot.file = file;
+        slot.mode = info.color_mode;
+    }
+    
+    return slot;
+}
+
+// Helper: Stream a PNG through the deflater at one ladder step, hashing the
+// converted pixels on the way if a hasher is given
+static void compressPixels(PngRowReader& reader, size_t step_index, std::vector<uint8_t>& out,
+                           bootmod::checksum::Hash64* hasher) {
+    const CompressionStep& step = COMPRESSION_LADDER[step_index];
+    CodecContext& codec = CodecContext::forThread();
+    
+    codec.deflateBegin(out, step.level, bootmod::DeflateFormat::ZLIB, step.strategy);
+    for (bootmod::ByteSpan band = reader.readBand(); !band.empty(); band = reader.readBand()) {
+        if (hasher) {
+            bootmod::StageTimer timer(bootmod::Stage::HASH);
+            hasher->update(band);
+        }
+        codec.deflateWrite(band);
+    }
+    codec.deflateFinish();
+}
+
+// Helper: First compression of a slot at its current ladder step. The same
+// decode measures the image and hashes its pixels for duplicate detection.
+static void compressSlot(RepackSlot& slot) {
+    bootmod::StatsScope scope(slotTiming(slot));
+    PngRowReader reader(slot.file, slot.mode);
+    bootmod::checksum::Hash64 hasher;
+    compressPixels(reader, slot.step, slot.blob, &hasher);
+    slot.blob_step = slot.step;
+    
+    slot.width = reader.width();
+    slot.height = reader.height();
+    slot.hash = hasher.finish();
+    slot.stats.width = slot.width;
+    slot.stats.height = slot.height;
+    slot.stats.frame_bytes = reader.frameSize();
+    
+    bootmod::appendFormat(slot.log, "  Loaded PNG: %ux%u, %zu bytes\n",
+                 slot.width, slot.height, reader.frameSize());
+}
+
+// Helper: Recompress a slot one step further up the ladder.
+// The smaller of the old and new blob is kept, blob_step says which it is.
+static void escalateSlot(RepackSlot& slot) {
+    bootmod::StatsScope scope(slotTiming(slot));
+    slot.step++;
+    
+    std::vector<uint8_t>& candidate = CodecContext::forThread().scratch();
+    PngRowReader reader(slot.file, slot.mode);
+    compressPixels(reader, slot.step, candidate, nullptr);
+    if (candidate.size() < slot.blob.size()) {
+        slot.blob.swap(candidate);
+        slot.blob_step = slot.step;
+    }
+}
+
+// Helper: Point slot i at an earlier compressed slot with the same pixels and
+// drop its own blob. Equal pixels at the same ladder step deflate to equal
+// blobs, so a hash hit is confirmed on the blobs without decoding again.
+// Duplicates are rare, compressing them once is cheaper than a second
+// decode of every slot.
+static bool findDuplicate(std::vector<RepackSlot>& slots, size_t i, const std::vector<size_t>& ids,
+                          std::unordered_map<uint64_t, size_t>& first_by_hash) {
+    RepackSlot& slot = slots[i];
+    slot.source = i;
+    if (slot.is_raw) {
+        return false;
+    }
+    
+    auto it = first_by_hash.find(slot.hash);
+    if (it == first_by_hash.end()) {
+        first_by_hash[slot.hash] = i;
+        return false;
+    }
+    
+    RepackSlot& first = slots[it->second];
+    bool same;
+    {
+        bootmod::StatsScope scope(slotTiming(slot));
+        bootmod::StageTimer timer(bootmod::Stage::HASH);
+        // Equal bytes in two layouts (e.g. BGRA and RGBA) are different images
+        same = first.width == slot.width && first.height == slot.height && first.mode == slot.mode &&
+               first.blob_step == slot.blob_step && first.blob == slot.blob;
+    }
+    if (!same) {
         return false;
     }
+    
+    slot.source = it->second;
+    first.uses++;
+    std::vector<uint8_t>().swap(slot.blob);
+    bootmod::appendFormat(slot.log, "  Duplicate of file %zu, reusing its compressed blob\n",
+                 ids[slot.source]);
+    return true;
+}
+
+// Helper: Append a slot's blob, or its source's for a duplicate, to the image
+static void writeSlot(LogoImageWriter& writer, std::vector<RepackSlot>& slots, size_t i) {
+    RepackSlot& slot = slots[i];
+    const std::vector<uint8_t>& blob = slots[slot.source].blob;
+    bootmod::StatsScope scope(slotTiming(slot));
+    bootmod::StageTimer timer(bootmod::Stage::WRITE);
+    writer.append(blob);
+    bootmod::countBytes(0, blob.size());
+    slot.stats.stored_bytes = blob.size();
+}
+
+// Helper: Image size for a set of slots, duplicates count with their source blob
+static uint64_t imageSize(const std::vector<RepackSlot>& slots) {
+    uint64_t total = MtkHeader::SIZE + (2 + slots.size()) * 4;
+    for (const auto& slot : slots) {
+        total += slots[slot.source].blob.size();
+    }
+    return total;
+}
+
+// Helper: Compress every slot at the cheapest setting, drop duplicates, then
+// escalate the largest unique blobs until the image fits. Each round
+// escalates as many slots as there are workers, weighted by how many slots
+// share the blob. Returns the number of duplicates.
+static size_t compressToTarget(bootmod::ThreadPool* pool, std::vector<RepackSlot>& slots,
+                               const std::vector<size_t>& ids, uint64_t target_size, std::string& log) {
+    bootmod::orderedParallelFor<size_t>(pool, slots.size(),
+        [&](size_t i) {
+            if (!slots[i].is_raw) {
+                slots[i].step = 0;
+                compressSlot(slots[i]);
+            }
+            return i;
+        },
+        [](size_t, size_t&) {});
+    
+    size_t duplicates = 0;
+    std::unordered_map<uint64_t, size_t> first_by_hash;
+    std::vector<size_t> unique;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (findDuplicate(slots, i, ids, first_by_hash)) {
+            duplicates++;
+        } else if (!slots[i].is_raw) {
+            unique.push_back(i);
+        }
+    }
+    
+    size_t batch = pool ? pool->getThreadCount() : 1;
+    size_t rounds = 0;
+    
+    while (imageSize(slots) > target_size) {
+        std::vector<size_t> candidates;
+        for (size_t i : unique) {
+            if (slots[i].step + 1 < COMPRESSION_STEPS) {
+                candidates.push_back(i);
+            }
+        }
+        
+        if (candidates.empty()) {
+            char message[160];
+            snprintf(message, sizeof(message),
+                     "Cannot fit into %llu bytes, smallest achievable size is %llu bytes",
+                     static_cast<unsigned long long>(target_size),
+                     static_cast<unsigned long long>(imageSize(slots)));
+            throw MtkLogoException(message);
+        }
+        
+        std::stable_sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+            return slots[a].blob.size() * slots[a].uses > slots[b].blob.size() * slots[b].uses;
+        });
+        candidates.resize(std::min(batch, candidates.size()));
+        
+        bootmod::orderedParallelFor<size_t>(pool, candidates.size(),
+            [&](size_t n) {
+                escalateSlot(slots[candidates[n]]);
+                return candidates[n];
+            },
+            [](size_t, size_t&) {});
+        rounds++;
+    }
+    
+    bootmod::appendFormat(log, "Target size: %llu bytes, fitted after %zu escalation round%s\n",
+                 static_cast<unsigned long long>(target_size), rounds, rounds == 1 ? "" : "s");
+    
+    for (size_t i : unique) {
+        bootmod::appendFormat(slots[i].log, "  Compressed: %zu bytes (%s)\n",
+                     slots[i].blob.size(), COMPRESSION_LADDER[slots[i].blob_step].name);
+    }
+    return duplicates;
 }
 
 bool MtkLogo::repack(const std::vector<std::string>& input_files,
                     const std::string& output_file,
-                    bool strip_alpha) {
+                    const RepackOptions& options) {
     try {
-        printf("Repacking %zu files into %s\n", input_files.size(), output_file.c_str());
+        std::string log;
+        bootmod::appendFormat(log, "Repacking %zu files into %s\n", input_files.size(), output_file.c_str());
+        emit(options.log, log);
         
         std::vector<std::pair<size_t, std::string>> sorted_files;
         
@@ -350,108 +1220,144 @@ bool MtkLogo::repack(const std::vector<std::string>& input_files,
         
         std::sort(sorted_files.begin(), sorted_files.end());
         
-        // Create blobs
-        std::vector<std::vector<uint8_t>> blobs;
+        // Slots are decoded and compressed concurrently, then written in order
+        std::unique_ptr<bootmod::ThreadPool> own_pool;
+        bootmod::ThreadPool* pool = options.pool;
+        size_t jobs = options.jobs;
+        if (jobs == 0) {
+            jobs = bootmod::ThreadPool::defaultThreadCount();
+        }
+        if (!pool && jobs > 1) {
+            own_pool.reset(new bootmod::ThreadPool(jobs));
+            pool = own_pool.get();
+        }
         
-        for (const auto& pair : sorted_files) {
-            size_t id = pair.first;
-            const std::string& file = pair.second;
-            
-            printf("Processing file %zu: %s\n", id, file.c_str());
-            
-            size_t last_slash = file.find_last_of("/\\");
-            std::string filename = (last_slash != std::string::npos) ? 
-                                  file.substr(last_slash + 1) : file;
-            
-            FileInfo info = FileInfo::fromFilename(filename);
-            
-            if (info.is_compressed) {
-                // Read raw file
-                std::ifstream in(file, std::ios::binary);
-                std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
-                                         std::istreambuf_iterator<char>());
-                blobs.push_back(data);
-            } else {
-                // Load PNG and convert
-                uint32_t width, height;
-                std::vector<uint8_t> pixels = ImageUtils::loadFromPNG(file, width, height, info.color_mode);
-                
-                printf("  Loaded PNG: %ux%u, %zu bytes\n", width, height, pixels.size());
+        // Load the unpack manifest of every input directory that has one
+        std::map<std::string, std::unique_ptr<ProjectManifest>> manifests;
+        std::vector<const ProjectManifest*> file_manifests(sorted_files.size(), nullptr);
+        if (options.use_manifest) {
+            for (size_t i = 0; i < sorted_files.size(); i++) {
+                const std::string& file = sorted_files[i].second;
+                size_t last_slash = file.find_last_of("/\\");
+                std::string dir = (last_slash != std::string::npos) ? file.substr(0, last_slash) : ".";
                 
-                // Compress
-                std::vector<uint8_t> compressed = ImageUtils::zlibCompress(pixels);
-                printf("  Compressed: %zu bytes\n", compressed.size());
-                
-                blobs.push_back(compressed);
+                auto it = manifests.find(dir);
+                if (it == manifests.end()) {
+                    std::unique_ptr<ProjectManifest> manifest(new ProjectManifest());
+                    if (!manifest->load(dir)) {
+                        manifest.reset();
+                    }
+                    it = manifests.insert(std::make_pair(dir, std::move(manifest))).first;
+                }
+                file_manifests[i] = it->second.get();
+            }
+        }
+        
+        // Manifest lookups and .z reads, PNGs are decoded once per compression
+        std::vector<RepackSlot> slots(sorted_files.size());
+        std::vector<size_t> ids(sorted_files.size());
+        bootmod::orderedParallelFor<RepackSlot>(pool, sorted_files.size(),
+            [&](size_t i) {
+                return loadSlot(sorted_files[i].first, sorted_files[i].second, file_manifests[i],
+                                options.stats != nullptr);
+            },
+            [&](size_t i, RepackSlot& slot) {
+                slots[i] = std::move(slot);
+                ids[i] = sorted_files[i].first;
+            });
+        
+        size_t reused = 0;
+        for (const auto& slot : slots) {
+            if (slot.reused) {
+                reused++;
+            }
+        }
+        
+        // Every blob must be known before the size check, nothing is
+        // written until the image fits
+        size_t duplicates = 0;
+        if (options.target_size > 0) {
+            log.clear();
+            duplicates = compressToTarget(pool, slots, ids, options.target_size, log);
+            emit(options.log, log);
+        }
+        
+        LogoImageWriter writer(output_file, slots.size());
+        
+        if (options.target_size > 0) {
+            for (size_t i = 0; i < slots.size(); i++) {
+                emit(options.log, slots[i].log);
+                writeSlot(writer, slots, i);
             }
+        } else {
+            // Slots are compressed at level 9 and written as soon as they
+            // are ready. Duplicates always follow their source, so they are
+            // found in index order against slots already written.
+            std::unordered_map<uint64_t, size_t> first_by_hash;
+            bootmod::orderedParallelFor<size_t>(pool, slots.size(),
+                [&](size_t i) {
+                    if (!slots[i].is_raw) {
+                        compressSlot(slots[i]);
+                    }
+                    return i;
+                },
+                [&](size_t i, size_t&) {
+                    RepackSlot& slot = slots[i];
+                    if (findDuplicate(slots, i, ids, first_by_hash)) {
+                        duplicates++;
+                    } else if (!slot.is_raw) {
+                        bootmod::appendFormat(slot.log, "  Compressed: %zu bytes\n", slot.blob.size());
+                    }
+                    emit(options.log, slot.log);
+                    writeSlot(writer, slots, i);
+                });
         }
         
-        // Create and write logo image
-        LogoImage image = LogoImage::createFromBlobs(blobs);
-        image.writeToFile(output_file);
+        // Patch the logo table
+        {
+            bootmod::StageTimer timer(bootmod::Stage::WRITE);
+            writer.finish();
+        }
         
-        printf("\nSuccessfully created: %s\n", output_file.c_str());
-        printf("Total size: %zu bytes\n", image.table.block_size + MtkHeader::SIZE);
+        if (options.stats) {
+            for (const auto& slot : slots) {
+                options.stats->push_back(slot.stats);
+            }
+        }
+        
+        log.clear();
+        bootmod::appendFormat(log, "\nSuccessfully created: %s\n", output_file.c_str());
+        if (reused > 0) {
+            bootmod::appendFormat(log, "Unchanged: %zu of %zu slots copied from the original image\n",
+                         reused, slots.size());
+        }
+        if (duplicates > 0) {
+            bootmod::appendFormat(log, "Deduplicated: %zu of %zu slots reused an identical slot's blob\n",
+                         duplicates, slots.size());
+        }
+        if (options.target_size > 0) {
+            bootmod::appendFormat(log, "Total size: %zu bytes (%llu bytes free)\n", writer.getTotalSize(),
+                         static_cast<unsigned long long>(options.target_size - writer.getTotalSize()));
+        } else {
+            bootmod::appendFormat(log, "Total size: %zu bytes\n", writer.getTotalSize());
+        }
+        emit(options.log, log);
         
         return true;
     } catch (const std::exception& e) {
-        fprintf(stderr, "Error: %s\n", e.what());
+        emitError(options.log, e.what());
         return false;
     }
 }
 
 std::vector<std::pair<uint32_t, uint32_t>> MtkLogo::guessDimensions(size_t byte_size,
                                                                      ColorMode mode) {
-    std::vector<std::pair<uint32_t, uint32_t>> results;
+    // Known panel and icon sizes are a single hash probe
+    std::vector<std::pair<uint32_t, uint32_t>> results = ProfileDatabase::generic().lookup(byte_size, mode);
     uint32_t bpp = ImageUtils::getBytesPerPixel(mode);
     
     size_t pixel_count = byte_size / bpp;
     
-    // Common screen dimensions (portrait orientation: width < height)
-    std::vector<std::pair<uint32_t, uint32_t>> common_resolutions = {
-        // Modern smartphones (portrait)
-        {720, 1600},   // HD+ (18:9)
-        {720, 1560},   // HD+ with notch
-        {720, 1520},   // HD+
-        {720, 1440},   // HD+ (18:9)
-        {720, 1280},   // HD (16:9)
-        {1080, 2400},  // FHD+ (20:9)
-        {1080, 2340},  // FHD+ with notch
-        {1080, 2280},  // FHD+ (19:9)
-        {1080, 2160},  // FHD+ (18:9)
-        {1080, 1920},  // FHD (16:9)
-        {1440, 3200},  // QHD+ (20:9)
-        {1440, 3040},  // QHD+ (19:9)
-        {1440, 2960},  // QHD+ (18.5:9)
-        {1440, 2880},  // QHD+ (18:9)
-        {1440, 2560},  // QHD (16:9)
-        // Older/smaller devices
-        {480, 854},    // FWVGA
-        {480, 800},    // WVGA
-        {540, 960},    // qHD
-        {600, 1024},   // WSVGA
-        {640, 1136},   // iPhone 5
-        {750, 1334},   // iPhone 6/7/8
-        // Small icons/indicators (prefer square, then portrait)
-        {28, 28},              // Square icons
-        {36, 50},              // Battery/charging indicator (portrait)
-        {50, 36},              // Battery/charging indicator (landscape)
-        {30, 60},              // Tall charging indicator
-        {60, 30},              // Wide charging indicator
-        {40, 45}, {45, 40},    // Tiny icons
-        {56, 14}, {14, 56},    // Progress bars
-        {7, 112}, {112, 7}     // Thin bars
-    };
-    
-    // Check common resolutions first
-    for (const auto& res : common_resolutions) {
-        uint32_t width = res.first;
-        uint32_t height = res.second;
-        if (width * height * bpp == byte_size) {
-            results.push_back({width, height});
-        }
-    }
-    
     // If not found in common resolutions, try factorization
     // but prefer dimensions with reasonable aspect ratios (portrait phone screens)
     if (results.empty()) {
@@ -0,0 +1,342 @@
+#include "checksum.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOOTMOD_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace bootmod {
+namespace checksum {
+
+// ============================================================================
+// CRC-32 Slice-by-8
+// ============================================================================
+
+// Reflected polynomial of CRC-32 (IEEE 802.3)
+static const uint32_t CRC32_POLY = 0xEDB88320u;
+
+struct Crc32Tables {
+    uint32_t t[8][256];
+
+    Crc32Tables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (c >> 1) ^ CRC32_POLY : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int s = 1; s < 8; s++) {
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+static const Crc32Tables& crcTables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+// Raw CRC register update, no pre/post inversion
+static uint32_t crc32Slice8(uint32_t crc, const uint8_t* p, size_t size) {
+    const Crc32Tables& tables = crcTables();
+    const uint32_t (*t)[256] = tables.t;
+
+    for (; size >= 8; p += 8, size -= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+
+    for (; size > 0; p++, size--) {
+        crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef BOOTMOD_X86_KERNELS
+
+// ============================================================================
+// CRC-32 PCLMULQDQ Folding
+// ============================================================================
+
+// Folding constants for the reflected polynomial, x^n mod P shifted for
+// 64-bit carry-less multiplies: k1/k2 fold 512 bits ahead, k3/k4 128 bits
+#define PCLMUL_TARGET __attribute__((target("pclmul,sse2")))
+
+PCLMUL_TARGET
+static inline __m128i fold128(__m128i x, __m128i k) {
+    __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(lo, hi);
+}
+
+PCLMUL_TARGET
+static uint32_t crc32Pclmul(uint32_t crc, const uint8_t* p, size_t size) {
+    if (size < 64) {
+        return crc32Slice8(crc, p, size);
+    }
+
+    const __m128i k1k2 = _mm_set_epi64x(0x1c6e41596LL, 0x154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x0ccaa009eLL, 0x1751997d0LL);
+
+    // The running CRC is folded in with the first four bytes
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                               _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+    p += 64;
+    size -= 64;
+
+    for (; size >= 64; p += 64, size -= 64) {
+        x0 = _mm_xor_si128(fold128(x0, k1k2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        x1 = _mm_xor_si128(fold128(x1, k1k2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+        x2 = _mm_xor_si128(fold128(x2, k1k2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+        x3 = _mm_xor_si128(fold128(x3, k1k2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+    }
+
+    // Four lanes down to one, then whole 16-byte blocks
+    x1 = _mm_xor_si128(fold128(x0, k3k4), x1);
+    x2 = _mm_xor_si128(fold128(x1, k3k4), x2);
+    x3 = _mm_xor_si128(fold128(x2, k3k4), x3);
+    for (; size >= 16; p += 16, size -= 16) {
+        x3 = _mm_xor_si128(fold128(x3, k3k4), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    // The folded block has the same remainder as everything before it,
+    // so its CRC from a zero register finishes the reduction
+    uint8_t folded[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), x3);
+    crc = crc32Slice8(0, folded, sizeof(folded));
+    return crc32Slice8(crc, p, size);
+}
+
+static bool cpuHasPclmul() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & bit_PCLMUL) && (edx & bit_SSE2);
+}
+
+#endif // BOOTMOD_X86_KERNELS
+
+// ============================================================================
+// CRC-32 Dispatch
+// ============================================================================
+
+struct Crc32Kernel {
+    uint32_t (*update)(uint32_t, const uint8_t*, size_t);
+    const char* name;
+};
+
+static Crc32Kernel selectCrc32Kernel() {
+    Crc32Kernel slice8 = {crc32Slice8, "slice8"};
+
+#ifdef BOOTMOD_X86_KERNELS
+    const char* cap = getenv("BOOTMOD_SIMD");
+    if ((!cap || strcmp(cap, "scalar") != 0) && cpuHasPclmul()) {
+        Crc32Kernel pclmul = {crc32Pclmul, "pclmul"};
+        return pclmul;
+    }
+#endif
+
+    return slice8;
+}
+
+static const Crc32Kernel& crc32Kernel() {
+    static const Crc32Kernel selected = selectCrc32Kernel();
+    return selected;
+}
+
+uint32_t crc32(uint32_t crc, ByteSpan data) {
+    return ~crc32Kernel().update(~crc, data.data, data.size);
+}
+
+const char* crc32KernelName() {
+    return crc32Kernel().name;
+}
+
+// ============================================================================
+// Adler-32
+// ============================================================================
+
+uint32_t adler32(uint32_t adler, ByteSpan data) {
+    static const uint32_t MOD = 65521;
+    static const size_t NMAX = 5552;  // Largest block whose sums cannot overflow 32 bits
+
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    const uint8_t* p = data.data;
+    size_t size = data.size;
+
+    while (size > 0) {
+        size_t block = size < NMAX ? size : NMAX;
+        size -= block;
+        for (; block >= 8; block -= 8, p += 8) {
+            a += p[0]; b += a;
+            a += p[1]; b += a;
+            a += p[2]; b += a;
+            a += p[3]; b += a;
+            a += p[4]; b += a;
+            a += p[5]; b += a;
+            a += p[6]; b += a;
+            a += p[7]; b += a;
+        }
+        for (; block > 0; block--, p++) {
+            a += *p;
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+
+    return (b << 16) | a;
+}
+
+// ============================================================================
+// Hash64 (XXH64)
+// ============================================================================
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t mergeRound64(uint64_t hash, uint64_t acc) {
+    hash ^= round64(0, acc);
+    return hash * PRIME64_1 + PRIME64_4;
+}
+
+// Four independent lanes per 32-byte stripe
+static inline void stripe64(uint64_t acc[4], const uint8_t* p) {
+    acc[0] = round64(acc[0], read64(p));
+    acc[1] = round64(acc[1], read64(p + 8));
+    acc[2] = round64(acc[2], read64(p + 16));
+    acc[3] = round64(acc[3], read64(p + 24));
+}
+
+Hash64::Hash64(uint64_t seed) : seed_(seed), total_(0), buffered_(0) {
+    acc_[0] = seed + PRIME64_1 + PRIME64_2;
+    acc_[1] = seed + PRIME64_2;
+    acc_[2] = seed;
+    acc_[3] = seed - PRIME64_1;
+}
+
+void Hash64::update(ByteSpan data) {
+    const uint8_t* p = data.data;
+    size_t size = data.size;
+    total_ += size;
+
+    // Complete a stripe left over from the previous piece
+    if (buffered_ > 0) {
+        size_t take = size < 32 - buffered_ ? size : 32 - buffered_;
+        memcpy(buffer_ + buffered_, p, take);
+        buffered_ += take;
+        p += take;
+        size -= take;
+        if (buffered_ < 32) {
+            return;
+        }
+        stripe64(acc_, buffer_);
+        buffered_ = 0;
+    }
+
+    for (; size >= 32; p += 32, size -= 32) {
+        stripe64(acc_, p);
+    }
+
+    if (size > 0) {
+        memcpy(buffer_, p, size);
+        buffered_ = size;
+    }
+}
+
+uint64_t Hash64::finish() const {
+    uint64_t hash;
+    if (total_ >= 32) {
+        hash = rotl64(acc_[0], 1) + rotl64(acc_[1], 7) + rotl64(acc_[2], 12) + rotl64(acc_[3], 18);
+        hash = mergeRound64(hash, acc_[0]);
+        hash = mergeRound64(hash, acc_[1]);
+        hash = mergeRound64(hash, acc_[2]);
+        hash = mergeRound64(hash, acc_[3]);
+    } else {
+        hash = seed_ + PRIME64_5;
+    }
+    hash += total_;
+
+    const uint8_t* p = buffer_;
+    size_t size = buffered_;
+    for (; size >= 8; p += 8, size -= 8) {
+        hash ^= round64(0, read64(p));
+        hash = rotl64(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (size >= 4) {
+        hash ^= static_cast<uint64_t>(read32(p)) * PRIME64_1;
+        hash = rotl64(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        size -= 4;
+    }
+    for (; size > 0; p++, size--) {
+        hash ^= *p * PRIME64_5;
+        hash = rotl64(hash, 11) * PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t hash64(ByteSpan data, uint64_t seed) {
+    Hash64 hasher(seed);
+    hasher.update(data);
+    return hasher.finish();
+}
+
+} // namespace checksum
+} // namespace bootmod
@@ -0,0 +1,695 @@
+#include "codec.h"
+#include "checksum.h"
+#include "stats.h"
+#include "../external/lodepng/lodepng.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+#ifdef BOOTMOD_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+namespace bootmod {
+
+// ============================================================================
+// Backend Selection
+// ============================================================================
+
+static std::atomic<int> g_default_backend(static_cast<int>(CodecBackend::ZLIB));
+
+bool isBackendAvailable(CodecBackend backend) {
+    switch (backend) {
+        case CodecBackend::ZLIB:
+        case CodecBackend::LODEPNG:
+            return true;
+        case CodecBackend::LIBDEFLATE:
+#ifdef BOOTMOD_HAVE_LIBDEFLATE
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+void setDefaultBackend(CodecBackend backend) {
+    if (!isBackendAvailable(backend)) {
+        throw CodecException("Codec backend not available in this build: " + getBackendName(backend));
+    }
+    g_default_backend.store(static_cast<int>(backend));
+}
+
+CodecBackend getDefaultBackend() {
+    return static_cast<CodecBackend>(g_default_backend.load());
+}
+
+std::string getBackendName(CodecBackend backend) {
+    switch (backend) {
+        case CodecBackend::ZLIB: return "zlib";
+        case CodecBackend::LODEPNG: return "lodepng";
+        case CodecBackend::LIBDEFLATE: return "libdeflate";
+    }
+    return "unknown";
+}
+
+CodecBackend parseBackend(const std::string& name) {
+    if (name == "zlib") return CodecBackend::ZLIB;
+    if (name == "lodepng") return CodecBackend::LODEPNG;
+    if (name == "libdeflate") return CodecBackend::LIBDEFLATE;
+    throw CodecException("Unknown codec backend: " + name);
+}
+
+// ============================================================================
+// Default Streaming
+// ============================================================================
+
+void DeflateBackend::deflateBegin(std::vector<uint8_t>& out, int level, DeflateFormat format,
+                                  DeflateStrategy strategy) {
+    stream_out_ = &out;
+    stream_pending_.clear();
+    stream_level_ = level;
+    stream_format_ = format;
+    stream_strategy_ = strategy;
+}
+
+void DeflateBackend::deflateWrite(ByteSpan src) {
+    stream_pending_.insert(stream_pending_.end(), src.begin(), src.end());
+}
+
+void DeflateBackend::deflateFinish() {
+    std::vector<uint8_t>& out = *stream_out_;
+    out.resize(deflateBound(stream_pending_.size(), stream_format_));
+    size_t size = deflateInto(stream_pending_, out.data(), out.size(),
+                              stream_level_, stream_format_, stream_strategy_);
+    out.resize(size);
+    stream_out_ = nullptr;
+    std::vector<uint8_t>().swap(stream_pending_);
+}
+
+void DeflateBackend::inflateBegin(ByteSpan src, DeflateFormat format) {
+    inflate(src, inflate_pending_, format);
+    inflate_offset_ = 0;
+}
+
+size_t DeflateBackend::inflateRead(uint8_t* dst, size_t capacity) {
+    size_t size = std::min(capacity, inflate_pending_.size() - inflate_offset_);
+    if (size > 0) {
+        memcpy(dst, inflate_pending_.data() + inflate_offset_, size);
+    }
+    inflate_offset_ += size;
+    if (inflate_offset_ == inflate_pending_.size()) {
+        inflateEnd();
+    }
+    return size;
+}
+
+void DeflateBackend::inflateEnd() {
+    std::vector<uint8_t>().swap(inflate_pending_);
+    inflate_offset_ = 0;
+}
+
+// ============================================================================
+// Zlib Backend
+// ============================================================================
+
+// Streams are reset between blobs instead of being set up and torn down
+// per call. The deflater is only rebuilt when level or framing changes.
+class ZlibBackend : public DeflateBackend {
+public:
+    ZlibBackend()
+        : inflater_ready_(false), deflater_ready_(false),
+          inflate_format_(DeflateFormat::ZLIB), deflate_format_(DeflateFormat::ZLIB),
+          deflate_strategy_(DeflateStrategy::DEFAULT), deflate_level_(-1), stream_produced_(0),
+          inflate_done_(true) {
+    }
+    
+    ~ZlibBackend() {
+        if (inflater_ready_) {
+            ::inflateEnd(&inflater_);
+        }
+        if (deflater_ready_) {
+            deflateEnd(&deflater_);
+        }
+    }
+    
+    CodecBackend kind() const override { return CodecBackend::ZLIB; }
+    bool streamsInflate() const override { return true; }
+    
+    size_t deflateBound(size_t size, DeflateFormat format) override {
+        // compressBound() covers the 6 byte zlib wrapper, raw needs less
+        (void)format;
+        return compressBound(size);
+    }
+    
+    size_t deflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       int level, DeflateFormat format, DeflateStrategy strategy) override {
+        resetDeflater(level, format, strategy);
+        
+        deflater_.next_in = const_cast<uint8_t*>(src.data);
+        deflater_.avail_in = src.size;
+        deflater_.next_out = dst;
+        deflater_.avail_out = capacity;
+        
+        int ret = ::deflate(&deflater_, Z_FINISH);
+        if (ret != Z_STREAM_END) {
+            throw CodecException("Zlib compression failed");
+        }
+        
+        return capacity - deflater_.avail_out;
+    }
+    
+    size_t inflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       DeflateFormat format) override {
+        resetInflater(format);
+        
+        inflater_.next_in = const_cast<uint8_t*>(src.data);
+        inflater_.avail_in = src.size;
+        inflater_.next_out = dst;
+        inflater_.avail_out = capacity;
+        
+        int ret = ::inflate(&inflater_, Z_FINISH);
+        if (ret != Z_STREAM_END) {
+            if (inflater_.avail_out == 0 && (ret == Z_OK || ret == Z_BUF_ERROR)) {
+                throw CodecException("Decompressed data exceeds buffer size");
+            }
+            throw CodecException("Zlib decompression failed");
+        }
+        
+        return capacity - inflater_.avail_out;
+    }
+    
+    void inflateEnd() override {
+        // The inflater is reset by the next inflateBegin()
+        inflate_done_ = true;
+    }
+    
+    void inflate(ByteSpan src, std::vector<uint8_t>& out, DeflateFormat format) override {
+        resetInflater(format);
+        
+        inflater_.next_in = const_cast<uint8_t*>(src.data);
+        inflater_.avail_in = src.size;
+        
+        // Start from whatever the buffer already holds, grow geometrically
+        const size_t MIN_SIZE = 65536;
+        out.resize(std::max(std::max(out.capacity(), src.size * 4), MIN_SIZE));
+        
+        size_t produced = 0;
+        for (;;) {
+            inflater_.next_out = out.data() + produced;
+            inflater_.avail_out = out.size() - produced;
+            
+            int ret = ::inflate(&inflater_, Z_NO_FLUSH);
+            produced = out.size() - inflater_.avail_out;
+            
+            if (ret == Z_STREAM_END) {
+                break;
+            }
+            if (ret != Z_OK && !(ret == Z_BUF_ERROR && inflater_.avail_out == 0)) {
+                throw CodecException("Zlib decompression failed");
+            }
+            if (inflater_.avail_out == 0) {
+                out.resize(out.size() * 2);
+            }
+        }
+        
+        out.resize(produced);
+    }
+    
+    void deflateBegin(std::vector<uint8_t>& out, int level, DeflateFormat format,
+                      DeflateStrategy strategy) override {
+        resetDeflater(level, format, strategy);
+        
+        // Output grows as the stream produces it, starting from the buffer's capacity
+        const size_t MIN_SIZE = 65536;
+        out.resize(std::max(out.capacity(), MIN_SIZE));
+        stream_out_ = &out;
+        stream_produced_ = 0;
+    }
+    
+    void deflateWrite(ByteSpan src) override {
+        pumpDeflater(src, Z_NO_FLUSH);
+    }
+    
+    void deflateFinish() override {
+        pumpDeflater(ByteSpan(), Z_FINISH);
+        stream_out_->resize(stream_produced_);
+        stream_out_ = nullptr;
+    }
+    
+    void inflateBegin(ByteSpan src, DeflateFormat format) override {
+        resetInflater(format);
+        inflater_.next_in = const_cast<uint8_t*>(src.data);
+        inflater_.avail_in = src.size;
+        inflate_done_ = false;
+    }
+    
+    size_t inflateRead(uint8_t* dst, size_t capacity) override {
+        inflater_.next_out = dst;
+        inflater_.avail_out = capacity;
+        
+        while (!inflate_done_ && inflater_.avail_out > 0) {
+            int ret = ::inflate(&inflater_, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                inflate_done_ = true;
+            } else if (ret != Z_OK) {
+                // Z_BUF_ERROR with room left means the input ran out early
+                throw CodecException("Zlib decompression failed");
+            }
+        }
+        
+        return capacity - inflater_.avail_out;
+    }
+
+private:
+    void pumpDeflater(ByteSpan src, int flush) {
+        std::vector<uint8_t>& out = *stream_out_;
+        deflater_.next_in = const_cast<uint8_t*>(src.data);
+        deflater_.avail_in = src.size;
+        
+        for (;;) {
+            if (stream_produced_ == out.size()) {
+                out.resize(out.size() * 2);
+            }
+            deflater_.next_out = out.data() + stream_produced_;
+            deflater_.avail_out = out.size() - stream_produced_;
+            
+            int ret = ::deflate(&deflater_, flush);
+            stream_produced_ = out.size() - deflater_.avail_out;
+            
+            if (ret == Z_STREAM_END) {
+                return;
+            }
+            if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                throw CodecException("Zlib compression failed");
+            }
+            // Without a flush, output space left over means all input was taken
+            if (flush == Z_NO_FLUSH && deflater_.avail_out > 0) {
+                return;
+            }
+        }
+    }
+    
+    static int windowBits(DeflateFormat format) {
+        return format == DeflateFormat::RAW ? -MAX_WBITS : MAX_WBITS;
+    }
+    
+    void resetInflater(DeflateFormat format) {
+        if (inflater_ready_) {
+            int ret = (format == inflate_format_)
+                ? inflateReset(&inflater_)
+                : inflateReset2(&inflater_, windowBits(format));
+            if (ret == Z_OK) {
+                inflate_format_ = format;
+                return;
+            }
+            ::inflateEnd(&inflater_);
+            inflater_ready_ = false;
+        }
+        
+        inflater_ = z_stream();
+        if (inflateInit2(&inflater_, windowBits(format)) != Z_OK) {
+            throw CodecException("Failed to initialize zlib inflation");
+        }
+        inflater_ready_ = true;
+        inflate_format_ = format;
+    }
+    
+    void resetDeflater(int level, DeflateFormat format, DeflateStrategy strategy) {
+        // Level, framing and strategy are fixed at init time
+        if (deflater_ready_ && deflate_level_ == level && deflate_format_ == format &&
+            deflate_strategy_ == strategy) {
+            deflateReset(&deflater_);
+            return;
+        }
+        
+        if (deflater_ready_) {
+            deflateEnd(&deflater_);
+            deflater_ready_ = false;
+        }
+        deflater_ = z_stream();
+        int z_strategy = (strategy == DeflateStrategy::FILTERED) ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+        if (deflateInit2(&deflater_, level, Z_DEFLATED, windowBits(format),
+                         8, z_strategy) != Z_OK) {
+            throw CodecException("Failed to initialize zlib deflation");
+        }
+        deflater_ready_ = true;
+        deflate_level_ = level;
+        deflate_format_ = format;
+        deflate_strategy_ = strategy;
+    }
+    
+    z_stream inflater_;
+    z_stream deflater_;
+    bool inflater_ready_;
+    bool deflater_ready_;
+    DeflateFormat inflate_format_;
+    DeflateFormat deflate_format_;
+    DeflateStrategy deflate_strategy_;
+    int deflate_level_;
+    size_t stream_produced_;
+    bool inflate_done_;
+};
+
+// ============================================================================
+// Lodepng Backend
+// ============================================================================
+
+// lodepng allocates its own output, so results are copied once into the
+// caller buffer. Kept for parity with the original splash code path.
+class LodepngBackend : public DeflateBackend {
+public:
+    CodecBackend kind() const override { return CodecBackend::LODEPNG; }
+    
+    size_t deflateBound(size_t size, DeflateFormat format) override {
+        // Level 0 writes stored blocks (5 bytes per 65535). Other levels
+        // never fall back to stored blocks, so incompressible data can cost
+        // up to 9 bits per byte plus a dynamic Huffman header per block of
+        // at least 64K. The zlib wrapper adds 6 bytes.
+        (void)format;
+        return size + size / 8 + (size / 65536 + 1) * 320 + 6;
+    }
+    
+    size_t deflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       int level, DeflateFormat format, DeflateStrategy) override {
+        LodePNGCompressSettings settings;
+        lodepng_compress_settings_init(&settings);
+        if (level <= 0) {
+            settings.btype = 0;
+        } else if (level >= 9) {
+            settings.windowsize = 32768;
+            settings.nicematch = 258;
+        } else if (level <= 3) {
+            settings.lazymatching = 0;
+        }
+        
+        unsigned char* out = nullptr;
+        size_t out_size = 0;
+        unsigned error = (format == DeflateFormat::RAW)
+            ? lodepng_deflate(&out, &out_size, src.data, src.size, &settings)
+            : lodepng_zlib_compress(&out, &out_size, src.data, src.size, &settings);
+        
+        if (error) {
+            free(out);
+            throw CodecException(std::string("lodepng compression failed: ") + lodepng_error_text(error));
+        }
+        
+        return copyOut(out, out_size, dst, capacity, "Compressed data exceeds buffer size");
+    }
+    
+    size_t inflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       DeflateFormat format) override {
+        unsigned char* out = nullptr;
+        size_t out_size = 0;
+        decode(src, &out, &out_size, capacity + 1, format);
+        return copyOut(out, out_size, dst, capacity, "Decompressed data exceeds buffer size");
+    }
+    
+    void inflate(ByteSpan src, std::vector<uint8_t>& out, DeflateFormat format) override {
+        unsigned char* data = nullptr;
+        size_t size = 0;
+        decode(src, &data, &size, 0, format);
+        out.assign(data, data + size);
+        free(data);
+    }
+
+private:
+    static void decode(ByteSpan src, unsigned char** out, size_t* out_size,
+                       size_t max_output, DeflateFormat format) {
+        LodePNGDecompressSettings settings;
+        lodepng_decompress_settings_init(&settings);
+        settings.max_output_size = max_output;
+        
+        unsigned error = (format == DeflateFormat::RAW)
+            ? lodepng_inflate(out, out_size, src.data, src.size, &settings)
+            : lodepng_zlib_decompress(out, out_size, src.data, src.size, &settings);
+        
+        if (error) {
+            free(*out);
+            *out = nullptr;
+            throw CodecException(std::string("lodepng decompression failed: ") + lodepng_error_text(error));
+        }
+    }
+    
+    static size_t copyOut(unsigned char* out, size_t out_size, uint8_t* dst, size_t capacity,
+                          const char* overflow_message) {
+        if (out_size > capacity) {
+            free(out);
+            throw CodecException(overflow_message);
+        }
+        if (out_size > 0) {
+            memcpy(dst, out, out_size);
+        }
+        free(out);
+        return out_size;
+    }
+};
+
+// ============================================================================
+// Libdeflate Backend
+// ============================================================================
+
+#ifdef BOOTMOD_HAVE_LIBDEFLATE
+
+// libdeflate is one-shot only, so the streaming inflate() has to guess the
+// output size and retry. Compressors are cached per level.
+class LibdeflateBackend : public DeflateBackend {
+public:
+    LibdeflateBackend() : decompressor_(nullptr) {
+        std::fill(compressors_, compressors_ + 13, static_cast<libdeflate_compressor*>(nullptr));
+    }
+    
+    ~LibdeflateBackend() {
+        for (libdeflate_compressor* c : compressors_) {
+            if (c) {
+                libdeflate_free_compressor(c);
+            }
+        }
+        if (decompressor_) {
+            libdeflate_free_decompressor(decompressor_);
+        }
+    }
+    
+    CodecBackend kind() const override { return CodecBackend::LIBDEFLATE; }
+    
+    size_t deflateBound(size_t size, DeflateFormat format) override {
+        libdeflate_compressor* c = compressor(9);
+        return format == DeflateFormat::RAW
+            ? libdeflate_deflate_compress_bound(c, size)
+            : libdeflate_zlib_compress_bound(c, size);
+    }
+    
+    size_t deflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       int level, DeflateFormat format, DeflateStrategy) override {
+        libdeflate_compressor* c = compressor(level);
+        size_t size = format == DeflateFormat::RAW
+            ? libdeflate_deflate_compress(c, src.data, src.size, dst, capacity)
+            : libdeflate_zlib_compress(c, src.data, src.size, dst, capacity);
+        if (size == 0 && src.size > 0) {
+            throw CodecException("Compressed data exceeds buffer size");
+        }
+        return size;
+    }
+    
+    size_t inflateInto(ByteSpan src, uint8_t* dst, size_t capacity,
+                       DeflateFormat format) override {
+        size_t produced = 0;
+        libdeflate_result ret = decompress(src, dst, capacity, &produced, format);
+        if (ret == LIBDEFLATE_INSUFFICIENT_SPACE) {
+            throw CodecException("Decompressed data exceeds buffer size");
+        }
+        if (ret != LIBDEFLATE_SUCCESS) {
+            throw CodecException("libdeflate decompression failed");
+        }
+        return produced;
+    }
+    
+    void inflate(ByteSpan src, std::vector<uint8_t>& out, DeflateFormat format) override {
+        const size_t MIN_SIZE = 65536;
+        out.resize(std::max(std::max(out.capacity(), src.size * 4), MIN_SIZE));
+        
+        for (;;) {
+            size_t produced = 0;
+            libdeflate_result ret = decompress(src, out.data(), out.size(), &produced, format);
+            if (ret == LIBDEFLATE_SUCCESS) {
+                out.resize(produced);
+                return;
+            }
+            if (ret != LIBDEFLATE_INSUFFICIENT_SPACE) {
+                throw CodecException("libdeflate decompression failed");
+            }
+            out.resize(out.size() * 2);
+        }
+    }
+
+private:
+    libdeflate_compressor* compressor(int level) {
+        level = std::min(std::max(level, 0), 12);
+        if (!compressors_[level]) {
+            compressors_[level] = libdeflate_alloc_compressor(level);
+            if (!compressors_[level]) {
+                throw CodecException("Failed to initialize libdeflate compressor");
+            }
+        }
+        return compressors_[level];
+    }
+    
+    libdeflate_result decompress(ByteSpan src, uint8_t* dst, size_t capacity,
+                                 size_t* produced, DeflateFormat format) {
+        if (!decompressor_) {
+            decompressor_ = libdeflate_alloc_decompressor();
+            if (!decompressor_) {
+                throw CodecException("Failed to initialize libdeflate decompressor");
+            }
+        }
+        return format == DeflateFormat::RAW
+            ? libdeflate_deflate_decompress(decompressor_, src.data, src.size, dst, capacity, produced)
+            : libdeflate_zlib_decompress(decompressor_, src.data, src.size, dst, capacity, produced);
+    }
+    
+    libdeflate_compressor* compressors_[13];
+    libdeflate_decompressor* decompressor_;
+};
+
+#endif // BOOTMOD_HAVE_LIBDEFLATE
+
+// ============================================================================
+// CodecContext Implementation
+// ============================================================================
+
+CodecContext::CodecContext() : stream_backend_(nullptr), inflate_backend_(nullptr) {
+}
+
+CodecContext::~CodecContext() {
+}
+
+CodecContext& CodecContext::forThread() {
+    static thread_local CodecContext context;
+    return context;
+}
+
+DeflateBackend& CodecContext::backend() {
+    CodecBackend kind = getDefaultBackend();
+    std::unique_ptr<DeflateBackend>& slot = backends_[static_cast<int>(kind)];
+    
+    if (!slot) {
+        switch (kind) {
+            case CodecBackend::ZLIB:
+                slot.reset(new ZlibBackend());
+                break;
+            case CodecBackend::LODEPNG:
+                slot.reset(new LodepngBackend());
+                break;
+            case CodecBackend::LIBDEFLATE:
+#ifdef BOOTMOD_HAVE_LIBDEFLATE
+                slot.reset(new LibdeflateBackend());
+                break;
+#else
+                throw CodecException("Codec backend not available in this build: libdeflate");
+#endif
+        }
+    }
+    
+    return *slot;
+}
+
+size_t CodecContext::deflateBound(size_t size, DeflateFormat format) {
+    return backend().deflateBound(size, format);
+}
+
+size_t CodecContext::inflateInto(ByteSpan src, uint8_t* dst, size_t capacity, DeflateFormat format) {
+    StageTimer timer(Stage::INFLATE);
+    return backend().inflateInto(src, dst, capacity, format);
+}
+
+void CodecContext::inflate(ByteSpan src, std::vector<uint8_t>& out, DeflateFormat format) {
+    StageTimer timer(Stage::INFLATE);
+    backend().inflate(src, out, format);
+}
+
+size_t CodecContext::deflateInto(ByteSpan src, uint8_t* dst, size_t capacity, int level,
+                                 DeflateFormat format, DeflateStrategy strategy) {
+    StageTimer timer(Stage::DEFLATE);
+    return backend().deflateInto(src, dst, capacity, level, format, strategy);
+}
+
+void CodecContext::deflate(ByteSpan src, std::vector<uint8_t>& out, int level,
+                           DeflateFormat format, DeflateStrategy strategy) {
+    StageTimer timer(Stage::DEFLATE);
+    
+    // Compress into the bound-sized buffer kept by the context, then copy
+    // out exactly what was produced so callers never hold the slack
+    DeflateBackend& codec = backend();
+    size_t bound = codec.deflateBound(src.size, format);
+    if (deflate_buffer_.size() < bound) {
+        deflate_buffer_.resize(bound);
+    }
+    
+    size_t size = codec.deflateInto(src, deflate_buffer_.data(), deflate_buffer_.size(),
+                                    level, format, strategy);
+    out.assign(deflate_buffer_.begin(), deflate_buffer_.begin() + size);
+}
+
+void CodecContext::deflateBegin(std::vector<uint8_t>& out, int level,
+                                DeflateFormat format, DeflateStrategy strategy) {
+    StageTimer timer(Stage::DEFLATE);
+    stream_backend_ = &backend();
+    stream_backend_->deflateBegin(out, level, format, strategy);
+}
+
+void CodecContext::deflateWrite(ByteSpan src) {
+    StageTimer timer(Stage::DEFLATE);
+    stream_backend_->deflateWrite(src);
+}
+
+void CodecContext::deflateFinish() {
+    StageTimer timer(Stage::DEFLATE);
+    DeflateBackend* codec = stream_backend_;
+    stream_backend_ = nullptr;
+    codec->deflateFinish();
+}
+
+void CodecContext::inflateBegin(ByteSpan src, DeflateFormat format) {
+    StageTimer timer(Stage::INFLATE);
+    inflate_backend_ = &backend();
+    inflate_backend_->inflateBegin(src, format);
+}
+
+size_t CodecContext::inflateRead(uint8_t* dst, size_t capacity) {
+    StageTimer timer(Stage::INFLATE);
+    return inflate_backend_->inflateRead(dst, capacity);
+}
+
+void CodecContext::inflateEnd() {
+    inflate_backend_->inflateEnd();
+}
+
+size_t CodecContext::inflatedSize(ByteSpan src, DeflateFormat format, uint32_t* crc) {
+    StageTimer timer(Stage::INFLATE);
+    discard_window_.resize(65536);
+    InflateScope stream(*this, src, format);
+    
+    size_t total = 0;
+    uint32_t running = 0;
+    for (size_t produced; (produced = stream.read(discard_window_.data(), discard_window_.size())) > 0;) {
+        total += produced;
+        if (crc) {
+            StageTimer hash_timer(Stage::HASH);
+            running = checksum::crc32(running, ByteSpan(discard_window_.data(), produced));
+        }
+    }
+    if (crc) {
+        *crc = running;
+    }
+    return total;
+}
+
+size_t CodecContext::inflatePeek(ByteSpan src, uint8_t* dst, size_t count, DeflateFormat format) {
+    StageTimer timer(Stage::INFLATE);
+    InflateScope stream(*this, src, format);
+    return stream.read(dst, count);
+}
+
+} // namespace bootmod
@@ -0,0 +1,476 @@
+#include "json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+namespace bootmod {
+
+// ============================================================================
+// JsonWriter Implementation
+// ============================================================================
+
+void JsonWriter::separate() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!first_.empty()) {
+        if (!first_.back()) {
+            out_ += ',';
+        }
+        first_.back() = false;
+    }
+}
+
+void JsonWriter::appendString(const std::string& text) {
+    out_ += '"';
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+            case '"':  out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out_ += escape;
+                } else {
+                    out_ += ch;
+                }
+        }
+    }
+    out_ += '"';
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    out_ += '{';
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    out_ += '}';
+    first_.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    out_ += '[';
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    out_ += ']';
+    first_.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const std::string& name) {
+    separate();
+    appendString(name);
+    out_ += ':';
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::string& text) {
+    separate();
+    appendString(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* text) {
+    return text ? value(std::string(text)) : null();
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out_ += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    // JSON has no NaN or infinity
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separate();
+    char text[32];
+    snprintf(text, sizeof(text), "%.6g", number);
+    // printf follows LC_NUMERIC, which Qt sets from the environment
+    char* comma = strchr(text, ',');
+    if (comma) {
+        *comma = '.';
+    }
+    out_ += text;
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_ += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(const std::string& json) {
+    separate();
+    out_ += json;
+    return *this;
+}
+
+JsonWriter& JsonWriter::signedValue(long long number) {
+    separate();
+    out_ += std::to_string(number);
+    return *this;
+}
+
+JsonWriter& JsonWriter::unsignedValue(unsigned long long number) {
+    separate();
+    out_ += std::to_string(number);
+    return *this;
+}
+
+// ============================================================================
+// JsonParser Implementation
+// ============================================================================
+
+// Recursive descent over the whole text, nesting is limited so hostile
+// input cannot exhaust the stack
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0), depth_(0) {}
+    
+    JsonValue document() {
+        JsonValue value = parseValue();
+        skipSpace();
+        if (pos_ != text_.size()) {
+            fail("unexpected text after the document");
+        }
+        return value;
+    }
+
+private:
+    static const int MAX_DEPTH = 64;
+    
+    void fail(const std::string& what) const {
+        size_t line = 1, column = 1;
+        for (size_t i = 0; i < pos_ && i < text_.size(); i++) {
+            if (text_[i] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        throw JsonException("JSON " + std::to_string(line) + ":" + std::to_string(column) + ": " + what);
+    }
+    
+    void skipSpace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+    
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+    
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+    
+    bool literal(const char* word) {
+        size_t length = strlen(word);
+        if (text_.compare(pos_, length, word) == 0) {
+            pos_ += length;
+            return true;
+        }
+        return false;
+    }
+    
+    JsonValue parseValue() {
+        skipSpace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        
+        JsonValue value;
+        char c = text_[pos_];
+        if (c == '{' || c == '[') {
+            if (++depth_ > MAX_DEPTH) {
+                fail("nested too deeply");
+            }
+            if (c == '{') {
+                parseObject(value);
+            } else {
+                parseArray(value);
+            }
+            depth_--;
+        } else if (c == '"') {
+            value.type_ = JsonValue::Type::STRING;
+            value.string_ = parseString();
+        } else if (literal("true")) {
+            value.type_ = JsonValue::Type::BOOL;
+            value.flag_ = true;
+        } else if (literal("false")) {
+            value.type_ = JsonValue::Type::BOOL;
+        } else if (literal("null")) {
+            value.type_ = JsonValue::Type::NUL;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            value.type_ = JsonValue::Type::NUMBER;
+            value.number_ = parseNumber();
+        } else {
+            fail(std::string("unexpected character '") + c + "'");
+        }
+        return value;
+    }
+    
+    void parseObject(JsonValue& value) {
+        value.type_ = JsonValue::Type::OBJECT;
+        pos_++;
+        if (consume('}')) {
+            return;
+        }
+        do {
+            skipSpace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("expected a member name");
+            }
+            std::string name = parseString();
+            expect(':');
+            value.members_.push_back(std::make_pair(name, parseValue()));
+        } while (consume(','));
+        expect('}');
+    }
+    
+    void parseArray(JsonValue& value) {
+        value.type_ = JsonValue::Type::ARRAY;
+        pos_++;
+        if (consume(']')) {
+            return;
+        }
+        do {
+            value.array_.push_back(parseValue());
+        } while (consume(','));
+        expect(']');
+    }
+    
+    // Helper: Append a code point as UTF-8
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    
+    uint32_t parseHex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("truncated \\u escape");
+        }
+        uint32_t code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                code |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                code |= c - 'A' + 10;
+            } else {
+                fail("invalid \\u escape");
+            }
+        }
+        return code;
+    }
+    
+    // Skip a run of digits, false if there was none
+    bool digits() {
+        size_t start = pos_;
+        while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+            pos_++;
+        }
+        return pos_ > start;
+    }
+    
+    double parseNumber() {
+        // Scan the JSON number grammar, then convert in the classic locale;
+        // strtod follows LC_NUMERIC and stops at the '.' in a comma locale
+        size_t start = pos_;
+        if (text_[pos_] == '-') {
+            pos_++;
+        }
+        bool valid = digits();
+        if (valid && pos_ < text_.size() && text_[pos_] == '.') {
+            pos_++;
+            valid = digits();
+        }
+        if (valid && pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            pos_++;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+                pos_++;
+            }
+            valid = digits();
+        }
+        
+        double number = 0;
+        if (valid) {
+            std::istringstream stream(text_.substr(start, pos_ - start));
+            stream.imbue(std::locale::classic());
+            stream >> number;
+            valid = !stream.fail() && std::isfinite(number);
+        }
+        if (!valid) {
+            pos_ = start;
+            fail("invalid number");
+        }
+        return number;
+    }
+    
+    std::string parseString() {
+        std::string out;
+        pos_++;  // Opening quote
+        for (;;) {
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            char escape = text_[pos_++];
+            switch (escape) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    uint32_t code = parseHex4();
+                    // Surrogate pair for characters beyond the BMP, halves
+                    // on their own have no UTF-8 encoding
+                    if (code >= 0xDC00 && code < 0xE000) {
+                        fail("unpaired low surrogate");
+                    }
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        if (!literal("\\u")) {
+                            fail("unpaired high surrogate");
+                        }
+                        uint32_t low = parseHex4();
+                        if (low < 0xDC00 || low >= 0xE000) {
+                            fail("invalid low surrogate");
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail(std::string("invalid escape '\\") + escape + "'");
+            }
+        }
+    }
+    
+    const std::string& text_;
+    size_t pos_;
+    int depth_;
+};
+
+// ============================================================================
+// JsonValue Implementation
+// ============================================================================
+
+JsonValue JsonValue::parse(const std::string& text) {
+    return JsonParser(text).document();
+}
+
+bool JsonValue::asBool() const {
+    if (type_ != Type::BOOL) {
+        throw JsonException("expected true or false");
+    }
+    return flag_;
+}
+
+double JsonValue::asNumber() const {
+    if (type_ != Type::NUMBER) {
+        throw JsonException("expected a number");
+    }
+    return number_;
+}
+
+uint64_t JsonValue::asUnsigned() const {
+    double number = asNumber();
+    if (number < 0 || number != std::floor(number) || number > 9007199254740992.0) {
+        throw JsonException("expected a non-negative integer");
+    }
+    return static_cast<uint64_t>(number);
+}
+
+const std::string& JsonValue::asString() const {
+    if (type_ != Type::STRING) {
+        throw JsonException("expected a string");
+    }
+    return string_;
+}
+
+const std::vector<JsonValue>& JsonValue::asArray() const {
+    if (type_ != Type::ARRAY) {
+        throw JsonException("expected an array");
+    }
+    return array_;
+}
+
+const std::vector<std::pair<std::string, JsonValue>>& JsonValue::members() const {
+    if (type_ != Type::OBJECT) {
+        throw JsonException("expected an object");
+    }
+    return members_;
+}
+
+const JsonValue* JsonValue::find(const std::string& name) const {
+    for (const auto& member : members_) {
+        if (member.first == name) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace bootmod
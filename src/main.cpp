@@ -1,6 +1,17 @@
 #include "bootmod.h"
+#include "json.h"
+#include "profile.h"
+#include "server.h"
 #include "splash.h"
+#include "stats.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <cstdio>
 #include <cstring>
 #include <vector>
 #include <experimental/filesystem>
@@ -14,28 +25,77 @@ namespace fs = std::experimental::filesystem;
 void printUsage(const char* program) {
     std::cout << "BootMod - Universal Boot Logo/Splash Editor v" << VERSION << "\n";
     std::cout << "Supports: MediaTek logo.bin, Qualcomm splash.img\n\n";
-    std::cout << "Usage: " << program << " <command> [options]\n\n";
+    std::cout << "Usage: " << program << " [--codec <name>] <command> [options]\n\n";
+    std::cout << "Global options:\n";
+    std::cout << "  --codec <name>         Deflate backend (zlib, lodepng, libdeflate; default: zlib)\n\n";
     std::cout << "Commands:\n";
     std::cout << "  unpack <logo.bin|splash.img> <output_dir> [options]\n";
     std::cout << "    Extract logos from boot image file\n";
+    std::cout << "    Options (both formats):\n";
+    std::cout << "      --jobs <n>           Worker threads (default: all CPU cores)\n";
+    std::cout << "      --json               One JSON report with per-slot sizes instead of progress text\n";
+    std::cout << "      --stats              Per-stage timings, bytes in/out and peak RSS\n";
     std::cout << "    Options (MTK only):\n";
     std::cout << "      --mode <mode>        Color mode (bgrabe, bgrale, rgbabe, rgbale, rgb565be, rgb565le)\n";
     std::cout << "      --slots <0,1,2>      Extract only specific slots (comma-separated)\n";
     std::cout << "      --raw                Extract as raw .z files without decompression\n";
     std::cout << "      --flip               Flip orientation\n";
+    std::cout << "      --profile <device>   Take slot dimensions from a device profile\n";
+    std::cout << "      --profile-db <file>  Load extra device profiles from a file\n";
     std::cout << "\n";
     std::cout << "  repack <output.bin> <file1> <file2> ... [options]\n";
     std::cout << "    Repack logo files into logo.bin (MTK format)\n";
     std::cout << "    Options:\n";
     std::cout << "      --strip-alpha        Remove alpha channel\n";
+    std::cout << "      --jobs <n>           Worker threads (default: all CPU cores)\n";
+    std::cout << "      --target-size <n>    Fit into n bytes using the fastest compression that does\n";
+    std::cout << "                           (decimal or 0x hex, e.g. the logo partition size)\n";
+    std::cout << "      --recompress         Ignore the unpack manifest, recompress every image\n";
+    std::cout << "      --json               One JSON report with per-slot sizes instead of progress text\n";
+    std::cout << "      --stats              Per-stage timings, bytes in/out and peak RSS\n";
     std::cout << "\n";
-    std::cout << "  info <logo.bin|splash.img>\n";
-    std::cout << "    Display information about boot image file\n";
+    std::cout << "  info <logo.bin|splash.img> [more files...] [options]\n";
+    std::cout << "    Display information about boot image files (pixels are never decoded)\n";
+    std::cout << "    Options:\n";
+    std::cout << "      --json               One JSON object per file\n";
+    std::cout << "      --no-inflate         Header and logo table only, skip decompressed sizes\n";
+    std::cout << "      --jobs <n>           Worker threads (default: all CPU cores)\n";
+    std::cout << "      --stats              Per-stage timings and bytes read, per file with --json\n";
+    std::cout << "\n";
+    std::cout << "  verify <logo.bin|splash.img> [more files...] [options]\n";
+    std::cout << "    Check every slot without writing anything (table, inflate, CRC, geometry).\n";
+    std::cout << "    Exits non-zero if any file has a broken slot.\n";
+    std::cout << "    Options:\n";
+    std::cout << "      --json               One JSON object per file\n";
+    std::cout << "      --quiet              List only slots with problems\n";
+    std::cout << "      --strict             Fail on warnings (e.g. unknown MTK resolution) too\n";
+    std::cout << "      --profile <device>   Expected MTK resolutions (default: generic)\n";
+    std::cout << "      --profile-db <file>  Load extra device profiles from a file\n";
+    std::cout << "      --jobs <n>           Worker threads (default: all CPU cores)\n";
+    std::cout << "\n";
+    std::cout << "  batch <manifest.json> [options]\n";
+    std::cout << "    Run unpack/repack/replace/verify tasks from a JSON manifest on one thread pool\n";
+    std::cout << "    Options:\n";
+    std::cout << "      --jobs <n>           Worker threads for all tasks together (default: all CPU cores)\n";
+    std::cout << "      --keep-going         Run later stages even after a task failed\n";
+    std::cout << "      --verbose            Show the output of every task, not only failed ones\n";
+    std::cout << "      --json               One JSON object per task\n";
+    std::cout << "\n";
+    std::cout << "  serve --socket <path> [options]\n";
+    std::cout << "    Keep images open and answer info/extract/replace/save requests on a Unix socket\n";
+    std::cout << "    Options:\n";
+    std::cout << "      --cache-mb <n>       Memory for extracted slots (default: 256)\n";
+    std::cout << "      --jobs <n>           Worker threads for info (default: all CPU cores)\n";
     std::cout << "\n";
-    std::cout << "  extract <splash.img> <index> <output.png>\n";
+    std::cout << "  call --socket <path> <request.json> [--data <file>]\n";
+    std::cout << "    Send one request to a running server and print the reply\n";
+    std::cout << "    Options:\n";
+    std::cout << "      --data <file>        Write the binary data that follows the reply here\n";
+    std::cout << "\n";
+    std::cout << "  extract <splash.img> <index> <output.png> [--json] [--stats]\n";
     std::cout << "    Extract single image from splash.img (Snapdragon)\n";
     std::cout << "\n";
-    std::cout << "  replace <splash.img> <index> <input.png> <output.img>\n";
+    std::cout << "  replace <splash.img> <index> <input.png> <output.img> [--json] [--stats]\n";
     std::cout << "    Replace single image in splash.img (Snapdragon)\n";
     std::cout << "\n";
     std::cout << "Examples:\n";
@@ -45,6 +105,10 @@ void printUsage(const char* program) {
     std::cout << "  " << program << " extract splash.img 0 logo.png\n";
     std::cout << "  " << program << " replace splash.img 0 new_logo.png output.img\n";
     std::cout << "  " << program << " info logo.bin\n";
+    std::cout << "  " << program << " unpack logo.bin extracted/ --json --stats\n";
+    std::cout << "  " << program << " verify --quiet out/logo.bin out/splash.img\n";
+    std::cout << "  " << program << " batch release.json --jobs 16\n";
+    std::cout << "  " << program << " call --socket /tmp/bootmod.sock '{\"cmd\": \"info\", \"file\": \"/work/logo.bin\"}'\n";
 }
 
 std::vector<size_t> parseSlots(const std::string& slots_str) {
@@ -62,6 +126,256 @@ std::vector<size_t> parseSlots(const std::string& slots_str) {
     return slots;
 }
 
+// Helper: Whole text as an unsigned number, what names it in the error.
+// stoull would accept "-1" and wrap it to 2^64 - 1.
+static uint64_t parseUnsigned(const std::string& text, int base, const char* what) {
+    size_t first = text.find_first_not_of(" \t");
+    size_t used = 0;
+    uint64_t value = 0;
+    if (first != std::string::npos && text[first] != '-' && text[first] != '+') {
+        try {
+            value = std::stoull(text, &used, base);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+    }
+    if (used == 0 || used != text.size()) {
+        throw std::invalid_argument(std::string("Invalid ") + what + ": " + text);
+    }
+    return value;
+}
+
+// Byte count in decimal or 0x-prefixed hex, as partition sizes are usually given
+static uint64_t parseSize(const std::string& text) {
+    return parseUnsigned(text, 0, "size");
+}
+
+// More worker threads than this is a typo, not a machine
+static const uint64_t MAX_JOBS = 1024;
+
+// Worker thread count for --jobs, 0 uses every CPU core
+static size_t parseJobs(const std::string& text) {
+    uint64_t jobs = parseUnsigned(text, 10, "job count");
+    if (jobs > MAX_JOBS) {
+        throw std::invalid_argument("Invalid job count: " + text + " (at most " +
+                                    std::to_string(MAX_JOBS) + ")");
+    }
+    return static_cast<size_t>(jobs);
+}
+
+// --cache-mb in bytes, refuses sizes whose byte count would overflow
+static size_t parseCacheSize(const std::string& text) {
+    uint64_t megabytes = parseUnsigned(text, 10, "cache size");
+    if (megabytes > (std::numeric_limits<size_t>::max() >> 20)) {
+        throw std::invalid_argument("Invalid cache size: " + text + " (too large)");
+    }
+    return static_cast<size_t>(megabytes) << 20;
+}
+
+// Built-in profiles first, files may add devices or extend them. profile is
+// left null without a name. Returns false after printing an error.
+static bool selectProfile(const std::string& profile_name, const std::vector<std::string>& profile_files,
+                          mtklogo::ProfileDatabase& profiles, const mtklogo::DeviceProfile*& profile) {
+    profiles = mtklogo::ProfileDatabase::builtin();
+    try {
+        for (const auto& file : profile_files) {
+            profiles.loadFile(file);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
+    
+    if (!profile_name.empty()) {
+        profile = profiles.find(profile_name);
+        if (!profile) {
+            std::cerr << "Error: Unknown device profile: " << profile_name << "\n";
+            std::cerr << "Available:";
+            for (const auto& name : profiles.names()) {
+                std::cerr << " " << name;
+            }
+            std::cerr << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Output settings of unpack, repack, info, extract and replace
+struct ReportOptions {
+    bool json;     // One JSON object instead of the progress text
+    bool stats;    // Stage timings, sizes and peak RSS
+    
+    ReportOptions() : json(false), stats(false) {}
+    
+    // Take arg if it is one of the report options
+    bool parse(const std::string& arg) {
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+// Timings of one command: per slot, and the work around the slots
+// (headers, tables, manifest) in run
+struct RunStats {
+    std::chrono::steady_clock::time_point start;
+    bootmod::StageStats run;
+    std::vector<bootmod::SlotStats> slots;
+    
+    RunStats() : start(std::chrono::steady_clock::now()) {}
+    
+    double wallSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    // Every stage of the run, slots included
+    bootmod::StageStats total() const {
+        bootmod::StageStats sum = run;
+        for (const auto& slot : slots) {
+            sum.add(slot.stages);
+        }
+        return sum;
+    }
+};
+
+// Helper: Compressed over decoded size, null if nothing was decoded
+static void writeRatio(bootmod::JsonWriter& w, uint64_t stored, uint64_t frame) {
+    w.key("ratio");
+    if (frame > 0) {
+        w.value(static_cast<double>(stored) / frame);
+    } else {
+        w.null();
+    }
+}
+
+// Helper: Seconds per stage and bytes read and written
+static void writeStages(bootmod::JsonWriter& w, const bootmod::StageStats& stages) {
+    w.key("seconds").beginObject();
+    for (size_t i = 0; i < bootmod::STAGE_COUNT; i++) {
+        bootmod::Stage stage = static_cast<bootmod::Stage>(i);
+        w.field(bootmod::stageName(stage), stages.seconds(stage));
+    }
+    w.field("total", stages.totalSeconds()).endObject();
+    w.field("bytes_in", stages.bytesIn()).field("bytes_out", stages.bytesOut());
+}
+
+// Helper: Peak RSS member, null where the platform does not tell
+static void writePeakRss(bootmod::JsonWriter& w) {
+    uint64_t peak = bootmod::peakResidentBytes();
+    w.key("peak_rss_bytes");
+    if (peak > 0) {
+        w.value(peak);
+    } else {
+        w.null();
+    }
+}
+
+// Helper: "slots" array of a report, timings only with --stats
+static void writeSlots(bootmod::JsonWriter& w, const std::vector<bootmod::SlotStats>& slots, bool timings) {
+    w.key("slots").beginArray();
+    for (const auto& slot : slots) {
+        w.beginObject()
+            .field("index", slot.index)
+            .field("file", slot.file);
+        if (slot.width > 0) {
+            w.field("width", slot.width).field("height", slot.height);
+        }
+        w.field("frame_bytes", slot.frame_bytes).field("stored_bytes", slot.stored_bytes);
+        writeRatio(w, slot.stored_bytes, slot.frame_bytes);
+        if (!slot.error.empty()) {
+            w.field("error", slot.error);
+        }
+        if (timings) {
+            w.key("stats").beginObject();
+            writeStages(w, slot.stages);
+            w.endObject();
+        }
+        w.endObject();
+    }
+    w.endArray();
+}
+
+// Helper: "stats" member of a report: stage totals, wall time and peak RSS
+static void writeRunStats(bootmod::JsonWriter& w, const RunStats& stats) {
+    uint64_t frame = 0;
+    uint64_t stored = 0;
+    for (const auto& slot : stats.slots) {
+        frame += slot.frame_bytes;
+        stored += slot.stored_bytes;
+    }
+    
+    w.key("stats").beginObject().field("wall_seconds", stats.wallSeconds());
+    writePeakRss(w);
+    writeStages(w, stats.total());
+    w.field("frame_bytes", frame).field("stored_bytes", stored);
+    writeRatio(w, stored, frame);
+    w.endObject();
+}
+
+// Helper: Text form of --stats, printed after the normal output
+static void printRunStats(const RunStats& stats) {
+    bootmod::StageStats total = stats.total();
+    char line[160];
+    
+    snprintf(line, sizeof(line), "\nStats: %.3f s wall, %.3f s in stages, peak RSS %.1f MiB\n",
+             stats.wallSeconds(), total.totalSeconds(), bootmod::peakResidentBytes() / 1048576.0);
+    std::cout << line;
+    for (size_t i = 0; i < bootmod::STAGE_COUNT; i++) {
+        bootmod::Stage stage = static_cast<bootmod::Stage>(i);
+        if (total.seconds(stage) > 0) {
+            snprintf(line, sizeof(line), "  %-11s %9.3f s\n", bootmod::stageName(stage), total.seconds(stage));
+            std::cout << line;
+        }
+    }
+    snprintf(line, sizeof(line), "  Bytes: %llu in, %llu out\n",
+             static_cast<unsigned long long>(total.bytesIn()),
+             static_cast<unsigned long long>(total.bytesOut()));
+    std::cout << line;
+}
+
+// Helper: Complete a run. With --json the report object started in w gets
+// ok/error, the slots and the stats and is printed; otherwise --stats
+// prints its summary. Returns the exit code.
+static int finishRun(bootmod::JsonWriter& w, const ReportOptions& report, const RunStats& stats,
+                     bool ok, const std::string& error = std::string()) {
+    if (report.json) {
+        w.field("ok", ok);
+        if (!ok && !error.empty()) {
+            w.field("error", error);
+        }
+        writeSlots(w, stats.slots, report.stats);
+        if (report.stats) {
+            writeRunStats(w, stats);
+        }
+        w.endObject();
+        std::cout << w.str() << "\n";
+    } else if (report.stats) {
+        printRunStats(stats);
+    }
+    return ok ? 0 : 1;
+}
+
+// Helper: Print the error lines of a log collected from the library to
+// stderr, returns the message of the last one
+static std::string reportErrors(const std::string& log) {
+    std::string last;
+    std::istringstream lines(log);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 7, "Error: ") == 0) {
+            std::cerr << line << "\n";
+            last = line.substr(7);
+        }
+    }
+    return last;
+}
+
 int cmdUnpack(int argc, char* argv[]) {
     if (argc < 4) {
         std::cerr << "Error: unpack requires <logo.bin|splash.img> <output_dir>\n";
@@ -71,68 +385,120 @@ int cmdUnpack(int argc, char* argv[]) {
     std::string input_file = argv[2];
     std::string output_dir = argv[3];
     
+    ReportOptions report;
+    for (int i = 4; i < argc; i++) {
+        report.parse(argv[i]);
+    }
+    RunStats stats;
+    bootmod::StatsScope scope(report.stats ? &stats.run : nullptr);
+    
     // Detect format
     bootmod::FormatType format = bootmod::detectFormat(input_file);
     
+    bootmod::JsonWriter w;
+    w.beginObject()
+        .field("command", "unpack")
+        .field("input", input_file)
+        .field("output", output_dir);
+    
     if (format == bootmod::FormatType::OPPO_SPLASH) {
         // Unpack Snapdragon splash.img
+        w.field("format", "splash");
         bootmod::splash::SplashImage splash;
         if (!splash.load(input_file)) {
             std::cerr << "Failed to load splash.img\n";
-            return 1;
+            return finishRun(w, report, stats, false, "Failed to load splash.img");
+        }
+        
+        size_t jobs = 0;
+        for (int i = 4; i < argc; i++) {
+            std::string arg = argv[i];
+            if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+                jobs = parseJobs(argv[++i]);
+            }
         }
         
         // Create output directory
         fs::create_directories(output_dir);
         
-        std::cout << "Unpacking Snapdragon splash.img...\n";
-        std::cout << "Image count: " << splash.getImageCount() << "\n";
-        
         uint32_t width, height;
         splash.getResolution(width, height);
-        std::cout << "Resolution: " << width << "x" << height << "\n\n";
+        if (!report.json) {
+            std::cout << "Unpacking Snapdragon splash.img...\n";
+            std::cout << "Image count: " << splash.getImageCount() << "\n";
+            std::cout << "Resolution: " << width << "x" << height << "\n\n";
+        }
         
-        for (uint32_t i = 0; i < splash.getImageCount(); i++) {
-            auto info = splash.getImageInfo(i);
-            std::string output_path = output_dir + "/image_" + std::to_string(i) + ".png";
-            
-            std::cout << "Extracting image " << i << ": " << info.name << " -> " << output_path << "\n";
-            if (!splash.extractImage(i, output_path)) {
-                std::cerr << "Failed to extract image " << i << "\n";
-                return 1;
+        auto image_path = [&](uint32_t i) {
+            return output_dir + "/image_" + std::to_string(i) + ".png";
+        };
+        
+        std::string error;
+        bool ok = splash.extractAll(image_path, jobs, [&](uint32_t i, bool extracted) {
+            if (!report.json) {
+                auto info = splash.getImageInfo(i);
+                std::cout << "Extracting image " << i << ": " << info.name << " -> " << image_path(i) << "\n";
             }
-        }
+            if (!extracted) {
+                error = "Failed to extract image " + std::to_string(i);
+                std::cerr << error << "\n";
+            }
+        }, &stats.slots);
         
-        std::cout << "\nExtraction complete!\n";
-        return 0;
+        if (ok && !report.json) {
+            std::cout << "\nExtraction complete!\n";
+        }
+        return finishRun(w, report, stats, ok, error);
         
     } else if (format == bootmod::FormatType::MTK_LOGO) {
         // Unpack MediaTek logo.bin
-        mtklogo::ColorMode mode = mtklogo::ColorMode::BGRA_BE;
-        std::vector<size_t> slots;
-        bool extract_raw = false;
-        bool flip = false;
+        w.field("format", "mtk_logo");
+        mtklogo::UnpackOptions options;
+        std::string profile_name;
+        std::vector<std::string> profile_files;
         
         // Parse options
         for (int i = 4; i < argc; i++) {
             std::string arg = argv[i];
             
             if (arg == "--mode" && i + 1 < argc) {
-                mode = mtklogo::ImageUtils::parseColorMode(argv[++i]);
+                options.mode = mtklogo::ImageUtils::parseColorMode(argv[++i]);
             } else if (arg == "--slots" && i + 1 < argc) {
-                slots = parseSlots(argv[++i]);
+                options.slots = parseSlots(argv[++i]);
             } else if (arg == "--raw") {
-                extract_raw = true;
+                options.extract_raw = true;
             } else if (arg == "--flip") {
-                flip = true;
+                options.flip = true;
+            } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+                options.jobs = parseJobs(argv[++i]);
+            } else if (arg == "--profile" && i + 1 < argc) {
+                profile_name = argv[++i];
+            } else if (arg == "--profile-db" && i + 1 < argc) {
+                profile_files.push_back(argv[++i]);
             }
         }
         
-        return mtklogo::MtkLogo::unpack(input_file, output_dir, mode, slots, extract_raw, flip) ? 0 : 1;
+        mtklogo::ProfileDatabase profiles;
+        if (!selectProfile(profile_name, profile_files, profiles, options.profile)) {
+            return finishRun(w, report, stats, false, "No usable device profile");
+        }
+        
+        // The JSON report replaces the progress log, errors still reach stderr
+        std::string log;
+        if (report.json) {
+            options.log = &log;
+        }
+        if (report.json || report.stats) {
+            options.stats = &stats.slots;
+        }
+        
+        bool ok = mtklogo::MtkLogo::unpack(input_file, output_dir, options);
+        std::string error = reportErrors(log);
+        return finishRun(w, report, stats, ok, error);
         
     } else {
         std::cerr << "Error: Unknown file format (not MTK logo.bin or OPPO splash.img)\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Unknown file format");
     }
 }
 
@@ -144,15 +510,22 @@ int cmdRepack(int argc, char* argv[]) {
     
     std::string output_file = argv[2];
     std::vector<std::string> input_files;
-    bool strip_alpha = false;
+    mtklogo::RepackOptions options;
+    ReportOptions report;
     
     // Parse files and options
     for (int i = 3; i < argc; i++) {
         std::string arg = argv[i];
         
         if (arg == "--strip-alpha") {
-            strip_alpha = true;
-        } else {
+            options.strip_alpha = true;
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            options.jobs = parseJobs(argv[++i]);
+        } else if (arg == "--recompress") {
+            options.use_manifest = false;
+        } else if (arg == "--target-size" && i + 1 < argc) {
+            options.target_size = parseSize(argv[++i]);
+        } else if (!report.parse(arg)) {
             input_files.push_back(arg);
         }
     }
@@ -162,7 +535,208 @@ int cmdRepack(int argc, char* argv[]) {
         return 1;
     }
     
-    return mtklogo::MtkLogo::repack(input_files, output_file, strip_alpha) ? 0 : 1;
+    RunStats stats;
+    bootmod::StatsScope scope(report.stats ? &stats.run : nullptr);
+    
+    std::string log;
+    if (report.json) {
+        options.log = &log;
+    }
+    if (report.json || report.stats) {
+        options.stats = &stats.slots;
+    }
+    
+    bool ok = mtklogo::MtkLogo::repack(input_files, output_file, options);
+    std::string error = reportErrors(log);
+    
+    bootmod::JsonWriter w;
+    w.beginObject()
+        .field("command", "repack")
+        .field("output", output_file)
+        .field("input_count", input_files.size());
+    if (ok && report.json) {
+        w.field("total_size", static_cast<uint64_t>(fs::file_size(output_file)));
+    }
+    return finishRun(w, report, stats, ok, error);
+}
+
+// Report of one file for cmdInfo and cmdVerify
+struct FileReport {
+    std::string out;
+    std::string err;
+    bool ok;
+    bootmod::StageStats stages;    // Filled with info --stats
+    
+    FileReport() : ok(false) {}
+};
+
+// Helper: "stats" member of one file's info object
+static void writeFileStats(bootmod::JsonWriter& w, const bootmod::StageStats& stages) {
+    w.key("stats").beginObject();
+    writeStages(w, stages);
+    writePeakRss(w);
+    w.endObject();
+}
+
+// Helper: Describe a Snapdragon splash.img
+static void infoSplash(const std::string& input_file, bool json, bool timed, FileReport& report) {
+    bootmod::splash::SplashImage splash;
+    if (!splash.load(input_file)) {
+        throw std::runtime_error("Failed to load splash.img");
+    }
+    
+    uint32_t width, height;
+    splash.getResolution(width, height);
+    
+    if (json) {
+        bootmod::JsonWriter w;
+        w.beginObject()
+            .field("file", input_file)
+            .field("format", "splash")
+            .field("width", width)
+            .field("height", height)
+            .field("image_count", splash.getImageCount());
+        w.key("images").beginArray();
+        for (uint32_t i = 0; i < splash.getImageCount(); i++) {
+            auto info = splash.getImageInfo(i);
+            w.beginObject()
+                .field("index", i)
+                .field("name", info.name)
+                .field("width", info.width)
+                .field("height", info.height)
+                .field("bpp", info.bpp)
+                .field("offset", info.offset)
+                .field("compressed_size", info.compressed_size)
+                .field("uncompressed_size", info.uncompressed_size)
+                .endObject();
+        }
+        w.endArray();
+        if (timed) {
+            writeFileStats(w, report.stages);
+        }
+        w.endObject();
+        report.out = w.str() + "\n";
+        return;
+    }
+    
+    std::ostringstream out;
+    out << "Snapdragon Splash Information\n";
+    out << "=============================\n";
+    out << "File: " << input_file << "\n";
+    out << "Format: OPPO/OnePlus splash.img\n";
+    out << "Resolution: " << width << "x" << height << "\n";
+    out << "Number of images: " << splash.getImageCount() << "\n\n";
+    out << "Image Details:\n";
+    
+    for (uint32_t i = 0; i < splash.getImageCount(); i++) {
+        auto info = splash.getImageInfo(i);
+        out << "  Image " << i << ": " << info.name << "\n";
+        if (info.bpp) {
+            out << "    Dimensions: " << info.width << "x" << info.height << " (" << info.bpp << "-bit BMP)\n";
+        }
+        out << "    Offset: 0x" << std::hex << info.offset << std::dec << "\n";
+        out << "    Compressed size: " << info.compressed_size << " bytes\n";
+        out << "    Uncompressed size: " << info.uncompressed_size << " bytes\n";
+    }
+    report.out = out.str();
+}
+
+// Helper: Describe a MediaTek logo.bin from its table, pixels are never decoded
+static void infoMtk(const std::string& input_file, bool json, bool measure, bool timed,
+                    bootmod::ThreadPool* pool, FileReport& report) {
+    mtklogo::LogoImageView image = mtklogo::LogoImageView::open(input_file);
+    std::vector<mtklogo::LogoSlotInfo> slots = mtklogo::MtkLogo::describe(image, measure, pool);
+    size_t total_size = mtklogo::MtkHeader::SIZE + image.table.block_size;
+    
+    if (json) {
+        bootmod::JsonWriter w;
+        w.beginObject()
+            .field("file", input_file)
+            .field("format", "mtk_logo")
+            .field("type", image.table.header.getTypeName())
+            .field("logo_count", image.table.logo_count)
+            .field("block_size", image.table.block_size)
+            .field("total_size", total_size);
+        w.key("logos").beginArray();
+        for (size_t i = 0; i < slots.size(); i++) {
+            const mtklogo::LogoSlotInfo& slot = slots[i];
+            w.beginObject()
+                .field("index", i + 1)
+                .field("offset", slot.offset)
+                .field("size", slot.size)
+                .field("compressed", slot.zlib);
+            w.key("decompressed_size");
+            if (slot.measured && !slot.corrupt) {
+                w.value(slot.decompressed_size);
+            } else {
+                w.null();
+            }
+            if (slot.measured) {
+                w.field("corrupt", slot.corrupt);
+            }
+            w.endObject();
+        }
+        w.endArray();
+        if (timed) {
+            writeFileStats(w, report.stages);
+        }
+        w.endObject();
+        report.out = w.str() + "\n";
+        return;
+    }
+    
+    std::ostringstream out;
+    out << "MTK Logo Information\n";
+    out << "====================\n";
+    out << "File: " << input_file << "\n";
+    out << "Type: " << image.table.header.getTypeName() << "\n";
+    out << "Number of logos: " << image.table.logo_count << "\n";
+    out << "Block size: " << image.table.block_size << " bytes\n";
+    out << "Total size: " << total_size << " bytes\n";
+    out << "\nLogo Details:\n";
+    
+    for (size_t i = 0; i < slots.size(); i++) {
+        const mtklogo::LogoSlotInfo& slot = slots[i];
+        out << "  Logo " << (i + 1) << ": " << slot.size << " bytes";
+        
+        if (slot.zlib) {
+            out << " (zlib compressed)";
+            if (slot.corrupt) {
+                out << " (decompression failed)";
+            } else if (slot.measured) {
+                out << " -> " << slot.decompressed_size << " bytes decompressed";
+            }
+        }
+        
+        out << "\n";
+    }
+    report.out = out.str();
+}
+
+// Helper: Describe one file of any supported format
+static FileReport infoFile(const std::string& input_file, bool json, bool measure,
+                           bootmod::ThreadPool* pool, bool timed = false) {
+    FileReport report;
+    bootmod::StatsScope scope(timed ? &report.stages : bootmod::StatsScope::current());
+    try {
+        bootmod::FormatType format = bootmod::detectFormat(input_file);
+        if (format == bootmod::FormatType::OPPO_SPLASH) {
+            infoSplash(input_file, json, timed, report);
+        } else if (format == bootmod::FormatType::MTK_LOGO) {
+            infoMtk(input_file, json, measure, timed, pool, report);
+        } else {
+            throw std::runtime_error("Unknown file format");
+        }
+        report.ok = true;
+    } catch (const std::exception& e) {
+        report.err = std::string("Error: ") + input_file + ": " + e.what() + "\n";
+        if (json) {
+            bootmod::JsonWriter w;
+            w.beginObject().field("file", input_file).field("error", e.what()).endObject();
+            report.out = w.str() + "\n";
+        }
+    }
+    return report;
 }
 
 int cmdInfo(int argc, char* argv[]) {
@@ -171,85 +745,786 @@ int cmdInfo(int argc, char* argv[]) {
         return 1;
     }
     
-    std::string input_file = argv[2];
-    bootmod::FormatType format = bootmod::detectFormat(input_file);
+    std::vector<std::string> input_files;
+    ReportOptions report;
+    bool measure = true;
+    size_t jobs = 0;
+    
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (report.parse(arg)) {
+            continue;
+        } else if (arg == "--no-inflate") {
+            measure = false;
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = parseJobs(argv[++i]);
+        } else {
+            input_files.push_back(arg);
+        }
+    }
+    
+    if (input_files.empty()) {
+        std::cerr << "Error: info requires <logo.bin|splash.img>\n";
+        return 1;
+    }
+    
+    // One pool for every file, blobs of different files inflate side by side
+    std::unique_ptr<bootmod::ThreadPool> pool;
+    if (jobs == 0) {
+        jobs = bootmod::ThreadPool::defaultThreadCount();
+    }
+    if (jobs > 1) {
+        pool.reset(new bootmod::ThreadPool(jobs));
+    }
+    
+    // With --json each file object carries its own stats
+    bool json = report.json;
+    RunStats stats;
+    bool all_ok = true;
+    bootmod::orderedParallelFor<FileReport>(pool.get(), input_files.size(),
+        [&](size_t i) {
+            return infoFile(input_files[i], json, measure, pool.get(), report.stats);
+        },
+        [&](size_t i, FileReport& file) {
+            if (i > 0 && !json) {
+                std::cout << "\n";
+            }
+            std::cout << file.out;
+            std::cerr << file.err;
+            all_ok = all_ok && file.ok;
+            stats.run.add(file.stages);
+        });
+    
+    if (report.stats && !json) {
+        printRunStats(stats);
+    }
+    return all_ok ? 0 : 1;
+}
+
+// One slot of a verify report, either format
+struct VerifySlot {
+    size_t offset;          // From the start of the file
+    size_t size;            // Stored size
+    size_t inflated_size;
+    std::string error;
+    std::string warning;
+    
+    VerifySlot() : offset(0), size(0), inflated_size(0) {}
+};
+
+// Settings shared by every file of a verify run
+struct VerifyOptions {
+    bool json;
+    bool quiet;      // Print only slots with problems
+    bool strict;     // Warnings fail the file too
+    const mtklogo::DeviceProfile* profile;
+    
+    VerifyOptions() : json(false), quiet(false), strict(false), profile(nullptr) {}
+};
+
+// Helper: Format the slot results of one file
+static void reportVerify(const std::string& input_file, const char* format, const char* label,
+                         const std::vector<VerifySlot>& slots, const VerifyOptions& options,
+                         FileReport& report) {
+    size_t errors = 0, warnings = 0;
+    for (const auto& slot : slots) {
+        errors += slot.error.empty() ? 0 : 1;
+        warnings += slot.warning.empty() ? 0 : 1;
+    }
+    report.ok = errors == 0 && (!options.strict || warnings == 0);
+    
+    if (options.json) {
+        bootmod::JsonWriter w;
+        w.beginObject()
+            .field("file", input_file)
+            .field("format", format)
+            .field("ok", report.ok)
+            .field("errors", errors)
+            .field("warnings", warnings);
+        w.key("slots").beginArray();
+        for (size_t i = 0; i < slots.size(); i++) {
+            const VerifySlot& slot = slots[i];
+            if (options.quiet && slot.error.empty() && slot.warning.empty()) {
+                continue;
+            }
+            w.beginObject()
+                .field("index", std::string(format) == "splash" ? i : i + 1)
+                .field("offset", slot.offset)
+                .field("size", slot.size)
+                .field("ok", slot.error.empty());
+            if (slot.error.empty()) {
+                w.field("inflated_size", slot.inflated_size);
+            } else {
+                w.field("error", slot.error);
+            }
+            if (!slot.warning.empty()) {
+                w.field("warning", slot.warning);
+            }
+            w.endObject();
+        }
+        w.endArray().endObject();
+        report.out = w.str() + "\n";
+        return;
+    }
+    
+    // Splash images are numbered from 0 everywhere else in the CLI, logos from 1
+    size_t first = std::string(format) == "splash" ? 0 : 1;
+    std::ostringstream out;
+    out << input_file << ": " << slots.size() << (slots.size() == 1 ? " slot" : " slots") << "\n";
+    for (size_t i = 0; i < slots.size(); i++) {
+        const VerifySlot& slot = slots[i];
+        if (options.quiet && slot.error.empty() && slot.warning.empty()) {
+            continue;
+        }
+        out << "  " << label << " " << (i + first) << " @0x" << std::hex << slot.offset << std::dec << ": ";
+        if (!slot.error.empty()) {
+            out << "ERROR: " << slot.error << "\n";
+            continue;
+        }
+        out << "OK, " << slot.size << " -> " << slot.inflated_size << " bytes";
+        if (!slot.warning.empty()) {
+            out << " (warning: " << slot.warning << ")";
+        }
+        out << "\n";
+    }
+    
+    out << "Result: " << (report.ok ? "OK" : "FAILED");
+    if (errors > 0) {
+        out << ", " << errors << " of " << slots.size() << " broken";
+    }
+    if (warnings > 0) {
+        out << ", " << warnings << " warning" << (warnings == 1 ? "" : "s");
+    }
+    out << "\n";
+    report.out = out.str();
+}
+
+// Helper: Verify one file of any supported format
+static FileReport verifyFile(const std::string& input_file, const VerifyOptions& options,
+                             bootmod::ThreadPool* pool) {
+    FileReport report;
+    try {
+        std::vector<VerifySlot> slots;
+        bootmod::FormatType format = bootmod::detectFormat(input_file);
+        
+        if (format == bootmod::FormatType::OPPO_SPLASH) {
+            // Files may be verified in parallel, the reason goes into the error
+            bootmod::splash::SplashImage splash;
+            std::string splash_log;
+            splash.setLog(&splash_log);
+            if (!splash.load(input_file)) {
+                while (!splash_log.empty() && splash_log.back() == '\n') {
+                    splash_log.pop_back();
+                }
+                throw std::runtime_error("Failed to load splash.img" +
+                                         (splash_log.empty() ? std::string() : ": " + splash_log));
+            }
+            std::vector<bootmod::splash::ImageCheck> checks = splash.verify(pool);
+            for (uint32_t i = 0; i < checks.size(); i++) {
+                auto info = splash.getImageInfo(i);
+                VerifySlot slot;
+                slot.offset = DATA_OFFSET + static_cast<size_t>(info.offset);
+                slot.size = info.compressed_size;
+                slot.inflated_size = checks[i].inflated_size;
+                slot.error = checks[i].error;
+                slot.warning = checks[i].warning;
+                slots.push_back(slot);
+            }
+            reportVerify(input_file, "splash", "Image", slots, options, report);
+        } else if (format == bootmod::FormatType::MTK_LOGO) {
+            std::vector<mtklogo::LogoSlotCheck> checks =
+                mtklogo::MtkLogo::verify(input_file, options.profile, pool);
+            for (const auto& check : checks) {
+                VerifySlot slot;
+                slot.offset = check.offset;
+                slot.size = check.size;
+                slot.inflated_size = check.decompressed_size;
+                slot.error = check.error;
+                slot.warning = check.warning;
+                slots.push_back(slot);
+            }
+            reportVerify(input_file, "mtk_logo", "Logo", slots, options, report);
+        } else {
+            throw std::runtime_error("Unknown file format");
+        }
+    } catch (const std::exception& e) {
+        report.ok = false;
+        report.err = std::string("Error: ") + input_file + ": " + e.what() + "\n";
+        if (options.json) {
+            bootmod::JsonWriter w;
+            w.beginObject().field("file", input_file).field("ok", false).field("error", e.what()).endObject();
+            report.out = w.str() + "\n";
+        } else {
+            report.out = input_file + ": FAILED\n";
+        }
+    }
+    return report;
+}
+
+int cmdVerify(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Error: verify requires <logo.bin|splash.img>\n";
+        return 1;
+    }
+    
+    std::vector<std::string> input_files;
+    VerifyOptions options;
+    size_t jobs = 0;
+    std::string profile_name;
+    std::vector<std::string> profile_files;
+    
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--quiet" || arg == "-q") {
+            options.quiet = true;
+        } else if (arg == "--strict") {
+            options.strict = true;
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = parseJobs(argv[++i]);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_name = argv[++i];
+        } else if (arg == "--profile-db" && i + 1 < argc) {
+            profile_files.push_back(argv[++i]);
+        } else {
+            input_files.push_back(arg);
+        }
+    }
+    
+    if (input_files.empty()) {
+        std::cerr << "Error: verify requires <logo.bin|splash.img>\n";
+        return 1;
+    }
+    
+    mtklogo::ProfileDatabase profiles;
+    if (!selectProfile(profile_name, profile_files, profiles, options.profile)) {
+        return 1;
+    }
+    
+    // Slots of every file share one pool, as in cmdInfo
+    std::unique_ptr<bootmod::ThreadPool> pool;
+    if (jobs == 0) {
+        jobs = bootmod::ThreadPool::defaultThreadCount();
+    }
+    if (jobs > 1) {
+        pool.reset(new bootmod::ThreadPool(jobs));
+    }
+    
+    bool all_ok = true;
+    bootmod::orderedParallelFor<FileReport>(pool.get(), input_files.size(),
+        [&](size_t i) {
+            return verifyFile(input_files[i], options, pool.get());
+        },
+        [&](size_t i, FileReport& report) {
+            if (i > 0 && !options.json && !options.quiet) {
+                std::cout << "\n";
+            }
+            std::cout << report.out;
+            std::cerr << report.err;
+            all_ok = all_ok && report.ok;
+        });
+    
+    return all_ok ? 0 : 1;
+}
+
+// Outcome of one batch task
+struct BatchResult {
+    bool ok;
+    std::string op;
+    std::string summary;   // What ran, e.g. "unpack a/logo.bin -> out/a"
+    std::string log;       // Progress and errors of the task
+    double seconds;
+    
+    BatchResult() : ok(false), seconds(0) {}
+};
+
+// Settings shared by every task of a batch
+struct BatchContext {
+    std::string base_dir;              // Relative manifest paths start here
+    mtklogo::ProfileDatabase profiles;
+    bootmod::ThreadPool* pool;
+    
+    BatchContext() : pool(nullptr) {}
+};
+
+// Helper: Manifest path relative to the manifest's directory
+static std::string batchPath(const BatchContext& context, const std::string& path) {
+    if (path.empty() || context.base_dir.empty() || fs::path(path).is_absolute()) {
+        return path;
+    }
+    return (fs::path(context.base_dir) / path).string();
+}
+
+// Helper: Member of a task, JSON type errors name the member
+static const bootmod::JsonValue* taskField(const bootmod::JsonValue& task, const char* name,
+                                           bool required = false) {
+    const bootmod::JsonValue* value = task.find(name);
+    if (!value && required) {
+        throw std::runtime_error(std::string("missing \"") + name + "\"");
+    }
+    return value;
+}
+
+static std::string taskString(const bootmod::JsonValue& task, const char* name) {
+    try {
+        return taskField(task, name, true)->asString();
+    } catch (const bootmod::JsonException& e) {
+        throw std::runtime_error(std::string("\"") + name + "\": " + e.what());
+    }
+}
+
+static bool taskBool(const bootmod::JsonValue& task, const char* name) {
+    const bootmod::JsonValue* value = taskField(task, name);
+    try {
+        return value && value->asBool();
+    } catch (const bootmod::JsonException& e) {
+        throw std::runtime_error(std::string("\"") + name + "\": " + e.what());
+    }
+}
+
+static uint64_t taskUnsigned(const bootmod::JsonValue& task, const char* name, uint64_t fallback) {
+    const bootmod::JsonValue* value = taskField(task, name);
+    if (!value) {
+        return fallback;
+    }
+    try {
+        // Sizes may also be written as "0x..." strings, like --target-size
+        return value->isString() ? parseSize(value->asString()) : value->asUnsigned();
+    } catch (const std::exception& e) {
+        throw std::runtime_error(std::string("\"") + name + "\": " + e.what());
+    }
+}
+
+// Required unsigned member, for values no default would be safe for
+static uint64_t taskUnsigned(const bootmod::JsonValue& task, const char* name) {
+    taskField(task, name, true);
+    return taskUnsigned(task, name, 0);
+}
+
+static const mtklogo::DeviceProfile* taskProfile(const bootmod::JsonValue& task,
+                                                 const BatchContext& context) {
+    if (!taskField(task, "profile")) {
+        return nullptr;
+    }
+    std::string name = taskString(task, "profile");
+    const mtklogo::DeviceProfile* profile = context.profiles.find(name);
+    if (!profile) {
+        throw std::runtime_error("Unknown device profile: " + name);
+    }
+    return profile;
+}
+
+// Helper: Create the directory an output file goes into
+static void createParent(const std::string& path) {
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) {
+        fs::create_directories(parent);
+    }
+}
+
+static bool batchUnpack(const bootmod::JsonValue& task, const BatchContext& context, BatchResult& result) {
+    std::string input = batchPath(context, taskString(task, "input"));
+    std::string output = batchPath(context, taskString(task, "output"));
+    result.summary = "unpack " + input + " -> " + output;
+    
+    bootmod::FormatType format = bootmod::detectFormat(input);
+    if (format != bootmod::FormatType::OPPO_SPLASH && format != bootmod::FormatType::MTK_LOGO) {
+        throw std::runtime_error("Unknown file format");
+    }
+    fs::create_directories(output);
     
     if (format == bootmod::FormatType::OPPO_SPLASH) {
-        // Show Snapdragon splash.img info
         bootmod::splash::SplashImage splash;
-        if (!splash.load(input_file)) {
-            std::cerr << "Failed to load splash.img\n";
-            return 1;
+        splash.setLog(&result.log);
+        if (!splash.load(input)) {
+            throw std::runtime_error("Failed to load splash.img");
+        }
+        auto image_path = [&](uint32_t i) {
+            return output + "/image_" + std::to_string(i) + ".png";
+        };
+        auto progress = [&](uint32_t i, bool extracted) {
+            result.log += (extracted ? "Extracted image " : "Failed to extract image ") +
+                          std::to_string(i) + " -> " + image_path(i) + "\n";
+        };
+        return context.pool ? splash.extractAll(image_path, *context.pool, progress)
+                            : splash.extractAll(image_path, 1, progress);
+    }
+    mtklogo::UnpackOptions options;
+    if (taskField(task, "mode")) {
+        options.mode = mtklogo::ImageUtils::parseColorMode(taskString(task, "mode"));
+    }
+    if (const bootmod::JsonValue* slots = taskField(task, "slots")) {
+        for (const auto& slot : slots->asArray()) {
+            options.slots.push_back(slot.asUnsigned());
+        }
+    }
+    options.extract_raw = taskBool(task, "raw");
+    options.flip = taskBool(task, "flip");
+    options.profile = taskProfile(task, context);
+    options.jobs = 1;
+    options.pool = context.pool;
+    options.log = &result.log;
+    return mtklogo::MtkLogo::unpack(input, output, options);
+}
+
+static bool batchRepack(const bootmod::JsonValue& task, const BatchContext& context, BatchResult& result) {
+    std::string output = batchPath(context, taskString(task, "output"));
+    
+    // A directory stands for its logo_* images, as a shell glob would
+    std::vector<std::string> inputs;
+    for (const auto& item : taskField(task, "inputs", true)->asArray()) {
+        std::string path = batchPath(context, item.asString());
+        if (!fs::is_directory(path)) {
+            inputs.push_back(path);
+            continue;
+        }
+        std::vector<std::string> found;
+        for (const auto& entry : fs::directory_iterator(path)) {
+            std::string name = entry.path().filename().string();
+            std::string ext = entry.path().extension().string();
+            if (name.compare(0, 5, "logo_") == 0 && (ext == ".png" || ext == ".z")) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        inputs.insert(inputs.end(), found.begin(), found.end());
+    }
+    result.summary = "repack " + std::to_string(inputs.size()) + " files -> " + output;
+    if (inputs.empty()) {
+        throw std::runtime_error("No input files");
+    }
+    
+    mtklogo::RepackOptions options;
+    options.strip_alpha = taskBool(task, "strip_alpha");
+    options.use_manifest = !taskBool(task, "recompress");
+    options.target_size = taskUnsigned(task, "target_size", 0);
+    options.jobs = 1;
+    options.pool = context.pool;
+    options.log = &result.log;
+    createParent(output);
+    return mtklogo::MtkLogo::repack(inputs, output, options);
+}
+
+static bool batchReplace(const bootmod::JsonValue& task, const BatchContext& context, BatchResult& result) {
+    std::string input = batchPath(context, taskString(task, "input"));
+    std::string image = batchPath(context, taskString(task, "image"));
+    std::string output = batchPath(context, taskString(task, "output"));
+    // No default, a missing index would quietly replace image 0
+    uint64_t index = taskUnsigned(task, "index");
+    result.summary = "replace " + input + " #" + std::to_string(index) + " with " + image + " -> " + output;
+    
+    bootmod::splash::SplashImage splash;
+    splash.setLog(&result.log);
+    if (!splash.load(input)) {
+        throw std::runtime_error("Failed to load splash.img");
+    }
+    if (index >= splash.getImageCount()) {
+        throw std::runtime_error("Invalid index: " + std::to_string(index));
+    }
+    if (!splash.replaceImage(static_cast<uint32_t>(index), image)) {
+        throw std::runtime_error("Failed to replace image");
+    }
+    createParent(output);
+    if (!splash.save(output)) {
+        throw std::runtime_error("Failed to save splash.img");
+    }
+    result.log += "Replaced image " + std::to_string(index) + "\n";
+    return true;
+}
+
+static bool batchVerify(const bootmod::JsonValue& task, const BatchContext& context, BatchResult& result) {
+    std::string input = batchPath(context, taskString(task, "input"));
+    result.summary = "verify " + input;
+    
+    VerifyOptions options;
+    options.quiet = true;
+    options.strict = taskBool(task, "strict");
+    options.profile = taskProfile(task, context);
+    FileReport report = verifyFile(input, options, context.pool);
+    result.log += report.out + report.err;
+    return report.ok;
+}
+
+// Helper: Run one task, failures end up in the result instead of throwing
+static BatchResult runBatchTask(const bootmod::JsonValue& task, const BatchContext& context) {
+    BatchResult result;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        result.op = taskString(task, "op");
+        result.summary = result.op;
+        if (result.op == "unpack") {
+            result.ok = batchUnpack(task, context, result);
+        } else if (result.op == "repack") {
+            result.ok = batchRepack(task, context, result);
+        } else if (result.op == "replace") {
+            result.ok = batchReplace(task, context, result);
+        } else if (result.op == "verify") {
+            result.ok = batchVerify(task, context, result);
+        } else {
+            throw std::runtime_error("Unknown op: " + result.op);
+        }
+    } catch (const std::exception& e) {
+        result.ok = false;
+        result.log += std::string("Error: ") + e.what() + "\n";
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int cmdBatch(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Error: batch requires <manifest.json>\n";
+        return 1;
+    }
+    
+    std::string manifest_path;
+    size_t jobs = 0;
+    bool json = false;
+    bool verbose = false;
+    bool keep_going = false;
+    
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = parseJobs(argv[++i]);
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--keep-going" || arg == "-k") {
+            keep_going = true;
+        } else {
+            manifest_path = arg;
+        }
+    }
+    
+    std::ifstream in(manifest_path);
+    if (!in) {
+        std::cerr << "Error: Cannot open manifest: " << manifest_path << "\n";
+        return 1;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    
+    // Stages run one after another, the tasks of a stage side by side
+    bootmod::JsonValue manifest;
+    std::vector<std::vector<const bootmod::JsonValue*>> stages;
+    BatchContext context;
+    context.base_dir = fs::path(manifest_path).parent_path().string();
+    try {
+        manifest = bootmod::JsonValue::parse(text.str());
+        if (const bootmod::JsonValue* tasks = manifest.find("tasks")) {
+            stages.push_back(std::vector<const bootmod::JsonValue*>());
+            for (const auto& task : tasks->asArray()) {
+                stages.back().push_back(&task);
+            }
+        }
+        if (const bootmod::JsonValue* list = manifest.find("stages")) {
+            for (const auto& stage : list->asArray()) {
+                stages.push_back(std::vector<const bootmod::JsonValue*>());
+                for (const auto& task : stage.asArray()) {
+                    stages.back().push_back(&task);
+                }
+            }
+        }
+        if (stages.empty()) {
+            throw std::runtime_error("manifest has neither \"tasks\" nor \"stages\"");
+        }
+        if (jobs == 0) {
+            // Same limit as --jobs, the count goes straight to the pool
+            uint64_t manifest_jobs = taskUnsigned(manifest, "jobs", 0);
+            if (manifest_jobs > MAX_JOBS) {
+                throw std::runtime_error("\"jobs\": " + std::to_string(manifest_jobs) + " is more than " +
+                                         std::to_string(MAX_JOBS));
+            }
+            jobs = static_cast<size_t>(manifest_jobs);
         }
         
-        uint32_t width, height;
-        splash.getResolution(width, height);
-        
-        std::cout << "Snapdragon Splash Information\n";
-        std::cout << "=============================\n";
-        std::cout << "File: " << input_file << "\n";
-        std::cout << "Format: OPPO/OnePlus splash.img\n";
-        std::cout << "Resolution: " << width << "x" << height << "\n";
-        std::cout << "Number of images: " << splash.getImageCount() << "\n\n";
-        std::cout << "Image Details:\n";
-        
-        for (uint32_t i = 0; i < splash.getImageCount(); i++) {
-            auto info = splash.getImageInfo(i);
-            std::cout << "  Image " << i << ": " << info.name << "\n";
-            std::cout << "    Offset: 0x" << std::hex << info.offset << std::dec << "\n";
-            std::cout << "    Compressed size: " << info.compressed_size << " bytes\n";
-            std::cout << "    Uncompressed size: " << info.uncompressed_size << " bytes\n";
+        context.profiles = mtklogo::ProfileDatabase::builtin();
+        if (const bootmod::JsonValue* files = manifest.find("profile_db")) {
+            for (const auto& file : files->asArray()) {
+                context.profiles.loadFile(batchPath(context, file.asString()));
+            }
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << manifest_path << ": " << e.what() << "\n";
+        return 1;
+    }
+    
+    size_t total = 0;
+    for (const auto& stage : stages) {
+        total += stage.size();
+    }
+    
+    // One pool for every task and every slot inside them; workers keep
+    // their codec context from task to task
+    std::unique_ptr<bootmod::ThreadPool> pool;
+    if (jobs == 0) {
+        jobs = bootmod::ThreadPool::defaultThreadCount();
+    }
+    if (jobs > 1) {
+        pool.reset(new bootmod::ThreadPool(jobs));
+    }
+    context.pool = pool.get();
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0, failed = 0, skipped = 0;
+    
+    for (size_t s = 0; s < stages.size(); s++) {
+        const std::vector<const bootmod::JsonValue*>& stage = stages[s];
         
-        return 0;
+        // Later stages usually consume what earlier ones wrote
+        if (failed > 0 && !keep_going) {
+            skipped += stage.size();
+            continue;
+        }
         
-    } else if (format == bootmod::FormatType::MTK_LOGO) {
-        // Show MediaTek logo.bin info
-        try {
-            mtklogo::LogoImage image = mtklogo::LogoImage::readFromFile(input_file);
-            
-            std::cout << "MTK Logo Information\n";
-            std::cout << "====================\n";
-            std::cout << "File: " << input_file << "\n";
-            std::cout << "Type: " << image.table.header.getTypeName() << "\n";
-            std::cout << "Number of logos: " << image.table.logo_count << "\n";
-            std::cout << "Block size: " << image.table.block_size << " bytes\n";
-            std::cout << "Total size: " << (mtklogo::MtkHeader::SIZE + image.table.block_size) << " bytes\n";
-            std::cout << "\nLogo Details:\n";
-            
-            for (size_t i = 0; i < image.getLogoCount(); i++) {
-                uint32_t size = image.table.getBlobSize(i);
-                std::cout << "  Logo " << (i + 1) << ": " << size << " bytes";
+        bootmod::orderedParallelFor<BatchResult>(pool.get(), stage.size(),
+            [&](size_t i) {
+                return runBatchTask(*stage[i], context);
+            },
+            [&](size_t i, BatchResult& result) {
+                done++;
+                failed += result.ok ? 0 : 1;
+                bool show_log = verbose || !result.ok;
                 
-                // Try to detect if compressed
-                const auto& blob = image.blobs[i];
-                if (blob.size() >= 2) {
-                    // Check for zlib header
-                    if ((blob[0] == 0x78 && (blob[1] == 0x01 || blob[1] == 0x9C || blob[1] == 0xDA))) {
-                        std::cout << " (zlib compressed)";
-                        
-                        try {
-                            auto decompressed = mtklogo::ImageUtils::zlibDecompress(blob);
-                            std::cout << " -> " << decompressed.size() << " bytes decompressed";
-                        } catch (...) {
-                            std::cout << " (decompression failed)";
+                if (json) {
+                    bootmod::JsonWriter w;
+                    w.beginObject()
+                        .field("task", done)
+                        .field("stage", s)
+                        .field("index", i)
+                        .field("op", result.op)
+                        .field("ok", result.ok)
+                        .field("summary", result.summary)
+                        .field("seconds", result.seconds);
+                    if (show_log) {
+                        w.field("log", result.log);
+                    }
+                    w.endObject();
+                    std::cout << w.str() << "\n";
+                } else {
+                    char line[64];
+                    snprintf(line, sizeof(line), "[%zu/%zu] %-6s ", done, total, result.ok ? "OK" : "FAILED");
+                    std::cout << line << result.summary;
+                    snprintf(line, sizeof(line), " (%.2f s)\n", result.seconds);
+                    std::cout << line;
+                    if (show_log) {
+                        std::istringstream log(result.log);
+                        for (std::string text; std::getline(log, text);) {
+                            std::cout << "    " << text << "\n";
                         }
                     }
                 }
-                
-                std::cout << "\n";
-            }
-            
-            return 0;
-        } catch (const std::exception& e) {
-            std::cerr << "Error: " << e.what() << "\n";
+                std::cout.flush();
+            });
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!json) {
+        char line[160];
+        snprintf(line, sizeof(line), "\nBatch: %zu of %zu tasks succeeded in %.2f s (%zu worker%s)",
+                 done - failed, total, seconds, jobs, jobs == 1 ? "" : "s");
+        std::cout << line;
+        if (skipped > 0) {
+            std::cout << ", " << skipped << " skipped after a failure";
+        }
+        std::cout << "\n";
+    }
+    
+    return failed == 0 && skipped == 0 ? 0 : 1;
+}
+
+int cmdServe(int argc, char* argv[]) {
+    bootmod::ServerOptions options;
+    size_t jobs = 0;
+    
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socket_path = argv[++i];
+        } else if (arg == "--cache-mb" && i + 1 < argc) {
+            options.cache_limit = parseCacheSize(argv[++i]);
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = parseJobs(argv[++i]);
+        } else {
+            std::cerr << "Error: Unknown serve option: " << arg << "\n";
             return 1;
         }
-        
-    } else {
-        std::cerr << "Error: Unknown file format\n";
+    }
+    
+    if (options.socket_path.empty()) {
+        std::cerr << "Error: serve requires --socket <path>\n";
+        return 1;
+    }
+    
+    std::unique_ptr<bootmod::ThreadPool> pool;
+    if (jobs == 0) {
+        jobs = bootmod::ThreadPool::defaultThreadCount();
+    }
+    if (jobs > 1) {
+        pool.reset(new bootmod::ThreadPool(jobs));
+    }
+    
+    // Same object as info --json prints
+    options.describe = [&](const std::string& file) {
+        FileReport report = infoFile(file, true, true, pool.get());
+        if (!report.ok) {
+            throw std::runtime_error(bootmod::JsonValue::parse(report.out).find("error")->asString());
+        }
+        return report.out;
+    };
+    
+    return bootmod::runServer(options);
+}
+
+int cmdCall(int argc, char* argv[]) {
+    std::string socket_path;
+    std::string request;
+    std::string data_file;
+    
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--data" && i + 1 < argc) {
+            data_file = argv[++i];
+        } else {
+            request = arg;
+        }
+    }
+    
+    if (socket_path.empty() || request.empty()) {
+        std::cerr << "Error: call requires --socket <path> <request.json>\n";
         return 1;
     }
+    
+    std::vector<uint8_t> data;
+    std::string reply = bootmod::callServer(socket_path, request, &data);
+    std::cout << reply << "\n";
+    
+    const bootmod::JsonValue* ok = bootmod::JsonValue::parse(reply).find("ok");
+    if (!data_file.empty() && !data.empty()) {
+        std::ofstream out(data_file, std::ios::binary);
+        if (!out.write(reinterpret_cast<const char*>(data.data()), data.size())) {
+            std::cerr << "Error: Failed to write " << data_file << "\n";
+            return 1;
+        }
+    }
+    return ok && ok->asBool() ? 0 : 1;
+}
+
+// Helper: Sizes of one splash image for a report
+static void fillSplashSlot(const bootmod::splash::SplashImage& splash, uint32_t index,
+                           const std::string& file, bootmod::SlotStats& slot) {
+    auto info = splash.getImageInfo(index);
+    slot.index = index;
+    slot.file = file;
+    slot.width = info.width;
+    slot.height = info.height;
+    slot.frame_bytes = info.uncompressed_size;
+    slot.stored_bytes = info.compressed_size;
 }
 
 int cmdExtract(int argc, char* argv[]) {
@@ -262,26 +1537,51 @@ int cmdExtract(int argc, char* argv[]) {
     int index = std::stoi(argv[3]);
     std::string output_file = argv[4];
     
+    ReportOptions report;
+    for (int i = 5; i < argc; i++) {
+        report.parse(argv[i]);
+    }
+    RunStats stats;
+    bootmod::StatsScope scope(report.stats ? &stats.run : nullptr);
+    
+    bootmod::JsonWriter w;
+    w.beginObject()
+        .field("command", "extract")
+        .field("input", input_file)
+        .field("output", output_file);
+    
     bootmod::splash::SplashImage splash;
     if (!splash.load(input_file)) {
         std::cerr << "Failed to load splash.img\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Failed to load splash.img");
     }
     
     if (index < 0 || index >= static_cast<int>(splash.getImageCount())) {
         std::cerr << "Invalid index: " << index << " (valid range: 0-" 
                   << (splash.getImageCount() - 1) << ")\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Invalid index: " + std::to_string(index));
     }
     
-    std::cout << "Extracting image " << index << " to " << output_file << "...\n";
-    if (!splash.extractImage(index, output_file)) {
+    if (!report.json) {
+        std::cout << "Extracting image " << index << " to " << output_file << "...\n";
+    }
+    stats.slots.resize(1);
+    bootmod::SlotStats& slot = stats.slots[0];
+    bool ok;
+    {
+        bootmod::StatsScope slot_scope(report.stats ? &slot.stages : nullptr);
+        ok = splash.extractImage(index, output_file);
+    }
+    fillSplashSlot(splash, index, output_file, slot);
+    if (!ok) {
         std::cerr << "Failed to extract image\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Failed to extract image");
     }
     
-    std::cout << "Extraction complete!\n";
-    return 0;
+    if (!report.json) {
+        std::cout << "Extraction complete!\n";
+    }
+    return finishRun(w, report, stats, true);
 }
 
 int cmdReplace(int argc, char* argv[]) {
@@ -295,35 +1595,95 @@ int cmdReplace(int argc, char* argv[]) {
     std::string input_png = argv[4];
     std::string output_splash = argv[5];
     
+    ReportOptions report;
+    for (int i = 6; i < argc; i++) {
+        report.parse(argv[i]);
+    }
+    RunStats stats;
+    bootmod::StatsScope scope(report.stats ? &stats.run : nullptr);
+    
+    bootmod::JsonWriter w;
+    w.beginObject()
+        .field("command", "replace")
+        .field("input", input_splash)
+        .field("output", output_splash);
+    
     bootmod::splash::SplashImage splash;
     if (!splash.load(input_splash)) {
         std::cerr << "Failed to load splash.img\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Failed to load splash.img");
     }
     
     if (index < 0 || index >= static_cast<int>(splash.getImageCount())) {
         std::cerr << "Invalid index: " << index << " (valid range: 0-" 
                   << (splash.getImageCount() - 1) << ")\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Invalid index: " + std::to_string(index));
     }
     
-    std::cout << "Replacing image " << index << " with " << input_png << "...\n";
-    if (!splash.replaceImage(index, input_png)) {
+    if (!report.json) {
+        std::cout << "Replacing image " << index << " with " << input_png << "...\n";
+        auto info = splash.getImageInfo(index);
+        if (info.bpp) {
+            std::cout << "  Original format: " << info.bpp << "-bit BMP\n";
+        }
+    }
+    stats.slots.resize(1);
+    bootmod::SlotStats& slot = stats.slots[0];
+    bool ok;
+    {
+        bootmod::StatsScope slot_scope(report.stats ? &slot.stages : nullptr);
+        ok = splash.replaceImage(index, input_png);
+    }
+    if (!ok) {
         std::cerr << "Failed to replace image\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Failed to replace image");
     }
+    fillSplashSlot(splash, index, input_png, slot);
     
-    std::cout << "Saving to " << output_splash << "...\n";
+    if (!report.json) {
+        std::cout << "Saving to " << output_splash << "...\n";
+    }
     if (!splash.save(output_splash)) {
         std::cerr << "Failed to save splash.img\n";
-        return 1;
+        return finishRun(w, report, stats, false, "Failed to save splash.img");
     }
     
-    std::cout << "Replacement complete!\n";
-    return 0;
+    if (!report.json) {
+        std::cout << "Replacement complete!\n";
+    }
+    return finishRun(w, report, stats, true);
+}
+
+// Remove options that apply to every command (--codec) from argv.
+// Returns false if one of them is invalid.
+bool parseGlobalOptions(int& argc, char* argv[]) {
+    int out = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--codec") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --codec requires a backend name\n";
+                return false;
+            }
+            try {
+                bootmod::setDefaultBackend(bootmod::parseBackend(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return false;
+            }
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    argv[argc] = nullptr;
+    return true;
 }
 
 int main(int argc, char* argv[]) {
+    if (!parseGlobalOptions(argc, argv)) {
+        return 1;
+    }
+    
     if (argc < 2) {
         printUsage(argv[0]);
         return 1;
@@ -338,6 +1698,14 @@ int main(int argc, char* argv[]) {
             return cmdRepack(argc, argv);
         } else if (command == "info") {
             return cmdInfo(argc, argv);
+        } else if (command == "verify") {
+            return cmdVerify(argc, argv);
+        } else if (command == "batch") {
+            return cmdBatch(argc, argv);
+        } else if (command == "serve") {
+            return cmdServe(argc, argv);
+        } else if (command == "call") {
+            return cmdCall(argc, argv);
         } else if (command == "extract") {
             return cmdExtract(argc, argv);
         } else if (command == "replace") {
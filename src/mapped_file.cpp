@@ -0,0 +1,140 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Read-only memory-mapped file implementation
+ */
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bootmod {
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+    , is_open_(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data_(nullptr)
+    , size_(0)
+    , is_open_(false) {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        close();
+        filename_ = std::move(other.filename_);
+        data_ = other.data_;
+        size_ = other.size_;
+        is_open_ = other.is_open_;
+#ifdef _WIN32
+        buffer_ = std::move(other.buffer_);
+        data_ = buffer_.data();
+#endif
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.is_open_ = false;
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    size_t size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    buffer_.resize(size);
+    file.read(reinterpret_cast<char*>(buffer_.data()), size);
+    if (!file) {
+        buffer_.clear();
+        return false;
+    }
+
+    filename_ = filename;
+    data_ = buffer_.data();
+    size_ = size;
+    is_open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    is_open_ = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    const uint8_t* data = nullptr;
+
+    // mmap() rejects zero-length mappings, an empty file is just an empty view
+    if (size > 0) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        data = static_cast<const uint8_t*>(addr);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+
+    filename_ = filename;
+    data_ = data;
+    size_ = size;
+    is_open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ && size_ > 0) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    is_open_ = false;
+}
+
+#endif
+
+} // namespace bootmod
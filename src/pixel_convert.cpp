@@ -0,0 +1,277 @@
+#include "pixel_convert.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOOTMOD_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace bootmod {
+namespace pixel {
+
+// ============================================================================
+// Scalar Kernels
+// ============================================================================
+
+static void swapRedBlueScalar(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+    for (size_t i = 0; i < pixel_count; i++) {
+        // Read the whole pixel first, src may alias dst
+        uint8_t c0 = src[0], c1 = src[1], c2 = src[2], c3 = src[3];
+        dst[0] = c2;
+        dst[1] = c1;
+        dst[2] = c0;
+        dst[3] = c3;
+        src += 4;
+        dst += 4;
+    }
+}
+
+static void rgb565ToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    for (size_t i = 0; i < pixel_count; i++) {
+        uint16_t v = big_endian ? static_cast<uint16_t>((src[0] << 8) | src[1])
+                                : static_cast<uint16_t>(src[0] | (src[1] << 8));
+        dst[0] = static_cast<uint8_t>((v >> 8) & 0xF8);
+        dst[1] = static_cast<uint8_t>((v >> 3) & 0xFC);
+        dst[2] = static_cast<uint8_t>((v << 3) & 0xF8);
+        dst[3] = 0xFF;
+        src += 2;
+        dst += 4;
+    }
+}
+
+static void rgbaToRgb565Scalar(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    for (size_t i = 0; i < pixel_count; i++) {
+        uint16_t v = static_cast<uint16_t>(((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) | (src[2] >> 3));
+        if (big_endian) {
+            dst[0] = static_cast<uint8_t>(v >> 8);
+            dst[1] = static_cast<uint8_t>(v & 0xFF);
+        } else {
+            dst[0] = static_cast<uint8_t>(v & 0xFF);
+            dst[1] = static_cast<uint8_t>(v >> 8);
+        }
+        src += 4;
+        dst += 2;
+    }
+}
+
+#ifdef BOOTMOD_X86_KERNELS
+
+// ============================================================================
+// SSE2 Kernels
+// ============================================================================
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+
+SSE2_TARGET
+static inline __m128i byteSwap16Sse2(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+// Four RGBA pixels to RGB565 in 32-bit lanes, biased for signed packing
+SSE2_TARGET
+static inline __m128i packRgb565Sse2(__m128i p) {
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x7E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1F));
+    __m128i v = _mm_or_si128(_mm_or_si128(r, g), b);
+    return _mm_sub_epi32(v, _mm_set1_epi32(0x8000));
+}
+
+SSE2_TARGET
+static void swapRedBlueSse2(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+    const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i swap = _mm_set1_epi32(0x00FF00FF);
+    
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i rb = _mm_and_si128(p, swap);
+        rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4),
+                         _mm_or_si128(_mm_and_si128(p, keep), rb));
+    }
+    swapRedBlueScalar(src + i * 4, dst + i * 4, pixel_count - i);
+}
+
+SSE2_TARGET
+static void rgb565ToRgbaSse2(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    const __m128i mask_rb = _mm_set1_epi16(0xF8);
+    const __m128i mask_g = _mm_set1_epi16(0xFC);
+    const __m128i alpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+    
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        if (big_endian) {
+            v = byteSwap16Sse2(v);
+        }
+        __m128i r = _mm_and_si128(_mm_srli_epi16(v, 8), mask_rb);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 3), mask_g);
+        __m128i b = _mm_and_si128(_mm_slli_epi16(v, 3), mask_rb);
+        __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        __m128i ba = _mm_or_si128(b, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+    rgb565ToRgbaScalar(src + i * 2, dst + i * 4, pixel_count - i, big_endian);
+}
+
+SSE2_TARGET
+static void rgbaToRgb565Sse2(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+    
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 16));
+        // SSE2 only has signed saturation, pack around the 0x8000 bias
+        __m128i v = _mm_packs_epi32(packRgb565Sse2(p0), packRgb565Sse2(p1));
+        v = _mm_xor_si128(v, bias);
+        if (big_endian) {
+            v = byteSwap16Sse2(v);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v);
+    }
+    rgbaToRgb565Scalar(src + i * 4, dst + i * 2, pixel_count - i, big_endian);
+}
+
+// ============================================================================
+// AVX2 Kernels
+// ============================================================================
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET
+static inline __m256i byteSwap16Avx2(__m256i v) {
+    return _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+}
+
+AVX2_TARGET
+static inline __m256i packRgb565Avx2(__m256i p) {
+    __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x7E0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 19), _mm256_set1_epi32(0x1F));
+    __m256i v = _mm256_or_si256(_mm256_or_si256(r, g), b);
+    return _mm256_sub_epi32(v, _mm256_set1_epi32(0x8000));
+}
+
+AVX2_TARGET
+static void swapRedBlueAvx2(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(p, shuffle));
+    }
+    swapRedBlueScalar(src + i * 4, dst + i * 4, pixel_count - i);
+}
+
+AVX2_TARGET
+static void rgb565ToRgbaAvx2(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    const __m256i mask_rb = _mm256_set1_epi16(0xF8);
+    const __m256i mask_g = _mm256_set1_epi16(0xFC);
+    const __m256i alpha = _mm256_set1_epi16(static_cast<short>(0xFF00));
+    
+    size_t i = 0;
+    for (; i + 16 <= pixel_count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+        if (big_endian) {
+            v = byteSwap16Avx2(v);
+        }
+        __m256i r = _mm256_and_si256(_mm256_srli_epi16(v, 8), mask_rb);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi16(v, 3), mask_g);
+        __m256i b = _mm256_and_si256(_mm256_slli_epi16(v, 3), mask_rb);
+        __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+        __m256i ba = _mm256_or_si256(b, alpha);
+        
+        // Unpacks work per 128-bit lane, put the pixels back in order
+        __m256i lo = _mm256_unpacklo_epi16(rg, ba);
+        __m256i hi = _mm256_unpackhi_epi16(rg, ba);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4),
+                            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4 + 32),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    rgb565ToRgbaScalar(src + i * 2, dst + i * 4, pixel_count - i, big_endian);
+}
+
+AVX2_TARGET
+static void rgbaToRgb565Avx2(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    const __m256i bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+    
+    size_t i = 0;
+    for (; i + 16 <= pixel_count; i += 16) {
+        __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4 + 32));
+        __m256i v = _mm256_packs_epi32(packRgb565Avx2(p0), packRgb565Avx2(p1));
+        v = _mm256_permute4x64_epi64(v, 0xD8);  // Undo the per-lane pack order
+        v = _mm256_xor_si256(v, bias);
+        if (big_endian) {
+            v = byteSwap16Avx2(v);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), v);
+    }
+    rgbaToRgb565Scalar(src + i * 4, dst + i * 2, pixel_count - i, big_endian);
+}
+
+#endif // BOOTMOD_X86_KERNELS
+
+// ============================================================================
+// Runtime Dispatch
+// ============================================================================
+
+struct Kernels {
+    void (*swap_red_blue)(const uint8_t*, uint8_t*, size_t);
+    void (*rgb565_to_rgba)(const uint8_t*, uint8_t*, size_t, bool);
+    void (*rgba_to_rgb565)(const uint8_t*, uint8_t*, size_t, bool);
+    const char* name;
+};
+
+static Kernels selectKernels() {
+    Kernels scalar = {swapRedBlueScalar, rgb565ToRgbaScalar, rgbaToRgb565Scalar, "scalar"};
+    
+#ifdef BOOTMOD_X86_KERNELS
+    const char* cap = getenv("BOOTMOD_SIMD");
+    bool allow_sse2 = !cap || strcmp(cap, "scalar") != 0;
+    bool allow_avx2 = allow_sse2 && (!cap || strcmp(cap, "sse2") != 0);
+    
+    __builtin_cpu_init();
+    if (allow_avx2 && __builtin_cpu_supports("avx2")) {
+        Kernels avx2 = {swapRedBlueAvx2, rgb565ToRgbaAvx2, rgbaToRgb565Avx2, "avx2"};
+        return avx2;
+    }
+    if (allow_sse2 && __builtin_cpu_supports("sse2")) {
+        Kernels sse2 = {swapRedBlueSse2, rgb565ToRgbaSse2, rgbaToRgb565Sse2, "sse2"};
+        return sse2;
+    }
+#endif
+    
+    return scalar;
+}
+
+static const Kernels& kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+    kernels().swap_red_blue(src, dst, pixel_count);
+}
+
+void rgb565ToRgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    kernels().rgb565_to_rgba(src, dst, pixel_count, big_endian);
+}
+
+void rgbaToRgb565(const uint8_t* src, uint8_t* dst, size_t pixel_count, bool big_endian) {
+    kernels().rgba_to_rgb565(src, dst, pixel_count, big_endian);
+}
+
+const char* kernelName() {
+    return kernels().name;
+}
+
+} // namespace pixel
+} // namespace bootmod
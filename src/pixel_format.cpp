@@ -0,0 +1,60 @@
+#include "pixel_format.h"
+
+namespace mtklogo {
+
+// ============================================================================
+// Conversion Tables
+// ============================================================================
+
+// Helper: row of the table for one source format
+template <ColorMode From>
+static PixelConvertFn converterFrom(ColorMode to) {
+    switch (to) {
+        case ColorMode::RGBA_BE:   return &PixelConverter<From, ColorMode::RGBA_BE>::run;
+        case ColorMode::RGBA_LE:   return &PixelConverter<From, ColorMode::RGBA_LE>::run;
+        case ColorMode::BGRA_BE:   return &PixelConverter<From, ColorMode::BGRA_BE>::run;
+        case ColorMode::BGRA_LE:   return &PixelConverter<From, ColorMode::BGRA_LE>::run;
+        case ColorMode::RGB565_BE: return &PixelConverter<From, ColorMode::RGB565_BE>::run;
+        case ColorMode::RGB565_LE: return &PixelConverter<From, ColorMode::RGB565_LE>::run;
+    }
+    throw MtkLogoException("Unsupported target color mode");
+}
+
+template <ColorMode From>
+static PixelConvertInPlaceFn inPlaceConverterFrom(ColorMode to) {
+    switch (to) {
+        case ColorMode::RGBA_BE:   return &convertPixelsInPlace<From, ColorMode::RGBA_BE>;
+        case ColorMode::RGBA_LE:   return &convertPixelsInPlace<From, ColorMode::RGBA_LE>;
+        case ColorMode::BGRA_BE:   return &convertPixelsInPlace<From, ColorMode::BGRA_BE>;
+        case ColorMode::BGRA_LE:   return &convertPixelsInPlace<From, ColorMode::BGRA_LE>;
+        case ColorMode::RGB565_BE: return &convertPixelsInPlace<From, ColorMode::RGB565_BE>;
+        case ColorMode::RGB565_LE: return &convertPixelsInPlace<From, ColorMode::RGB565_LE>;
+    }
+    throw MtkLogoException("Unsupported target color mode");
+}
+
+PixelConvertFn getPixelConverter(ColorMode from, ColorMode to) {
+    switch (from) {
+        case ColorMode::RGBA_BE:   return converterFrom<ColorMode::RGBA_BE>(to);
+        case ColorMode::RGBA_LE:   return converterFrom<ColorMode::RGBA_LE>(to);
+        case ColorMode::BGRA_BE:   return converterFrom<ColorMode::BGRA_BE>(to);
+        case ColorMode::BGRA_LE:   return converterFrom<ColorMode::BGRA_LE>(to);
+        case ColorMode::RGB565_BE: return converterFrom<ColorMode::RGB565_BE>(to);
+        case ColorMode::RGB565_LE: return converterFrom<ColorMode::RGB565_LE>(to);
+    }
+    throw MtkLogoException("Unsupported source color mode");
+}
+
+PixelConvertInPlaceFn getInPlacePixelConverter(ColorMode from, ColorMode to) {
+    switch (from) {
+        case ColorMode::RGBA_BE:   return inPlaceConverterFrom<ColorMode::RGBA_BE>(to);
+        case ColorMode::RGBA_LE:   return inPlaceConverterFrom<ColorMode::RGBA_LE>(to);
+        case ColorMode::BGRA_BE:   return inPlaceConverterFrom<ColorMode::BGRA_BE>(to);
+        case ColorMode::BGRA_LE:   return inPlaceConverterFrom<ColorMode::BGRA_LE>(to);
+        case ColorMode::RGB565_BE: return inPlaceConverterFrom<ColorMode::RGB565_BE>(to);
+        case ColorMode::RGB565_LE: return inPlaceConverterFrom<ColorMode::RGB565_LE>(to);
+    }
+    throw MtkLogoException("Unsupported source color mode");
+}
+
+} // namespace mtklogo
@@ -0,0 +1,186 @@
+#include "profile.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace mtklogo {
+
+// Built-in profiles, in the same format as profile files
+static const char* BUILTIN_PROFILES =
+    "device generic\n"
+    // Modern smartphones (portrait)
+    "resolution 720x1600 720x1560 720x1520 720x1440 720x1280\n"
+    "resolution 1080x2400 1080x2340 1080x2280 1080x2160 1080x1920\n"
+    "resolution 1440x3200 1440x3040 1440x2960 1440x2880 1440x2560\n"
+    // Older/smaller devices
+    "resolution 480x854 480x800 540x960 600x1024 640x1136 750x1334\n"
+    // Small icons/indicators (prefer square, then portrait)
+    "resolution 28x28 36x50 50x36 30x60 60x30 40x45 45x40 56x14 14x56 7x112 112x7\n";
+
+// ============================================================================
+// DeviceProfile Implementation
+// ============================================================================
+
+void DeviceProfile::addResolution(uint32_t width, uint32_t height) {
+    uint64_t pixels = static_cast<uint64_t>(width) * height;
+    
+    // Index the frame size for both pixel widths (RGB565 and 32-bit)
+    const uint32_t BPP[] = {2, 4};
+    for (uint32_t bpp : BPP) {
+        std::vector<Dimensions>& hits = by_size_[key(pixels * bpp, bpp)];
+        Dimensions dims(width, height);
+        if (std::find(hits.begin(), hits.end(), dims) == hits.end()) {
+            hits.push_back(dims);
+        }
+    }
+}
+
+void DeviceProfile::setSlot(size_t id, uint32_t width, uint32_t height) {
+    slots_[id] = Dimensions(width, height);
+}
+
+const std::vector<Dimensions>& DeviceProfile::lookup(size_t byte_size, ColorMode mode) const {
+    static const std::vector<Dimensions> none;
+    auto it = by_size_.find(key(byte_size, ImageUtils::getBytesPerPixel(mode)));
+    return it != by_size_.end() ? it->second : none;
+}
+
+bool DeviceProfile::dimensionsFor(size_t id, size_t byte_size, ColorMode mode,
+                                  Dimensions& out) const {
+    auto slot = slots_.find(id);
+    if (slot != slots_.end()) {
+        uint64_t frame = static_cast<uint64_t>(slot->second.first) * slot->second.second *
+                         ImageUtils::getBytesPerPixel(mode);
+        if (frame == byte_size) {
+            out = slot->second;
+            return true;
+        }
+    }
+    
+    const std::vector<Dimensions>& hits = lookup(byte_size, mode);
+    if (hits.empty()) {
+        return false;
+    }
+    out = hits.front();
+    return true;
+}
+
+// ============================================================================
+// ProfileDatabase Implementation
+// ============================================================================
+
+// Helper: Parse "<W>x<H>", both non-zero
+static bool parseDimensions(const std::string& text, Dimensions& out) {
+    unsigned long width = 0, height = 0;
+    char x = 0, extra = 0;
+    std::istringstream in(text);
+    if (!(in >> width >> x >> height) || x != 'x' || (in >> extra) ||
+        width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF) {
+        return false;
+    }
+    out = Dimensions(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    return true;
+}
+
+void ProfileDatabase::parse(const std::string& text, const std::string& source) {
+    std::istringstream in(text);
+    std::string line;
+    DeviceProfile* current = nullptr;
+    
+    for (size_t line_number = 1; std::getline(in, line); line_number++) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) {
+            continue;
+        }
+        
+        std::string where = source + ":" + std::to_string(line_number) + ": ";
+        
+        if (keyword == "device") {
+            std::string name;
+            if (!(fields >> name)) {
+                throw MtkLogoException(where + "device needs a name");
+            }
+            auto it = profiles_.find(name);
+            if (it == profiles_.end()) {
+                it = profiles_.insert(std::make_pair(name, DeviceProfile(name))).first;
+            }
+            current = &it->second;
+            continue;
+        }
+        
+        if (!current) {
+            throw MtkLogoException(where + keyword + " before any device");
+        }
+        
+        if (keyword == "resolution") {
+            std::string item;
+            size_t count = 0;
+            for (; fields >> item; count++) {
+                Dimensions dims;
+                if (!parseDimensions(item, dims)) {
+                    throw MtkLogoException(where + "invalid resolution: " + item);
+                }
+                current->addResolution(dims.first, dims.second);
+            }
+            if (count == 0) {
+                throw MtkLogoException(where + "resolution needs at least one <W>x<H>");
+            }
+        } else if (keyword == "slot") {
+            size_t id = 0;
+            std::string item;
+            Dimensions dims;
+            if (!(fields >> id >> item) || id == 0 || !parseDimensions(item, dims)) {
+                throw MtkLogoException(where + "expected slot <n> <W>x<H>");
+            }
+            current->setSlot(id, dims.first, dims.second);
+        } else {
+            throw MtkLogoException(where + "unknown keyword: " + keyword);
+        }
+    }
+}
+
+void ProfileDatabase::loadFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw MtkLogoException("Cannot open profile file: " + path);
+    }
+    
+    std::stringstream text;
+    text << in.rdbuf();
+    parse(text.str(), path);
+}
+
+const DeviceProfile* ProfileDatabase::find(const std::string& name) const {
+    auto it = profiles_.find(name);
+    return it != profiles_.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> ProfileDatabase::names() const {
+    std::vector<std::string> result;
+    for (const auto& profile : profiles_) {
+        result.push_back(profile.first);
+    }
+    return result;
+}
+
+const ProfileDatabase& ProfileDatabase::builtin() {
+    static const ProfileDatabase database = []() {
+        ProfileDatabase db;
+        db.parse(BUILTIN_PROFILES, "<builtin>");
+        return db;
+    }();
+    return database;
+}
+
+const DeviceProfile& ProfileDatabase::generic() {
+    static const DeviceProfile& profile = *builtin().find("generic");
+    return profile;
+}
+
+} // namespace mtklogo
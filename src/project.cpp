@@ -0,0 +1,191 @@
+#include "project.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <cstdlib>
+#include <cstring>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace mtklogo {
+
+const char* ProjectManifest::MANIFEST_NAME = "bootmod.manifest";
+const char* ProjectManifest::ORIGINAL_NAME = "original.bin";
+
+// Bumped whenever the file hash changes, older manifests are ignored
+static const int MANIFEST_VERSION = 2;
+
+// Helper: True if both paths resolve to the same existing file
+static bool isSameFile(const std::string& a, const std::string& b) {
+#ifdef _WIN32
+    char full_a[_MAX_PATH], full_b[_MAX_PATH];
+    if (!_fullpath(full_a, a.c_str(), sizeof(full_a)) || !_fullpath(full_b, b.c_str(), sizeof(full_b))) {
+        return false;
+    }
+    return _stricmp(full_a, full_b) == 0;
+#else
+    struct stat sa, sb;
+    if (stat(a.c_str(), &sa) != 0 || stat(b.c_str(), &sb) != 0) {
+        return false;
+    }
+    return sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+#endif
+}
+
+uint64_t ProjectManifest::hashFile(const std::string& path, uint64_t* size) {
+    bootmod::MappedFile file;
+    if (!file.open(path)) {
+        throw MtkLogoException("Cannot open file: " + path);
+    }
+    
+    if (size) {
+        *size = file.size();
+    }
+    return ImageUtils::hashBytes(bootmod::ByteSpan(file.data(), file.size()));
+}
+
+void ProjectManifest::add(const std::string& dir, size_t id, ColorMode mode, const std::string& file) {
+    ManifestEntry entry;
+    entry.id = id;
+    entry.mode = mode;
+    entry.file = file;
+    entry.file_hash = hashFile(dir + "/" + file, &entry.file_size);
+    entries.push_back(entry);
+}
+
+void ProjectManifest::save(const std::string& dir, const std::string& original_file) const {
+    // Keep the original image next to the manifest. Unpacking dir/original.bin
+    // itself must not truncate it, and a failed copy must not leave a stub
+    // where an earlier good copy was.
+    std::string original_copy = dir + "/" + ORIGINAL_NAME;
+    if (!isSameFile(original_file, original_copy)) {
+        std::string temp = original_copy + ".tmp";
+        bool copied;
+        {
+            std::ifstream in(original_file, std::ios::binary);
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            copied = in && out && (out << in.rdbuf());
+            if (copied) {
+                out.close();
+                copied = !out.fail();
+            }
+        }
+#ifdef _WIN32
+        // rename() does not replace an existing file on Windows
+        if (copied) {
+            std::remove(original_copy.c_str());
+        }
+#endif
+        if (!copied || std::rename(temp.c_str(), original_copy.c_str()) != 0) {
+            std::remove(temp.c_str());
+            throw MtkLogoException("Failed to write file: " + original_copy);
+        }
+    }
+    
+    std::string manifest_path = dir + "/" + MANIFEST_NAME;
+    std::ofstream out(manifest_path);
+    if (!out) {
+        throw MtkLogoException("Failed to write file: " + manifest_path);
+    }
+    
+    // One slot per line, file name last so it may contain spaces
+    out << "# BootMod unpack manifest, used by repack to reuse unchanged slots\n";
+    out << "version " << MANIFEST_VERSION << "\n";
+    for (const auto& entry : entries) {
+        char hash[17];
+        snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(entry.file_hash));
+        out << "slot " << entry.id << " " << ImageUtils::getColorModeName(entry.mode) << " "
+            << entry.file_size << " " << hash << " " << entry.file << "\n";
+    }
+    
+    if (!out) {
+        throw MtkLogoException("Failed to write file: " + manifest_path);
+    }
+}
+
+bool ProjectManifest::load(const std::string& dir) {
+    std::ifstream in(dir + "/" + MANIFEST_NAME);
+    if (!in) {
+        return false;
+    }
+    
+    try {
+        readEntries(in);
+        original_ = LogoImageView::open(dir + "/" + ORIGINAL_NAME);
+    } catch (const std::exception&) {
+        // Unreadable manifest or original.bin, repack recompresses
+        entries.clear();
+        return false;
+    }
+    
+    // Every entry must name a slot of the original, else it is from another image
+    for (const auto& entry : entries) {
+        if (entry.id == 0 || entry.id > original_.getLogoCount()) {
+            entries.clear();
+            return false;
+        }
+    }
+    
+    dir_ = dir;
+    return !entries.empty();
+}
+
+void ProjectManifest::readEntries(std::istream& in) {
+    entries.clear();
+    std::string line;
+    int version = 0;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        if (!(fields >> tag)) {
+            continue;
+        }
+        if (tag == "version") {
+            fields >> version;
+            continue;
+        }
+        if (tag != "slot") {
+            continue;
+        }
+        
+        ManifestEntry entry;
+        std::string mode, hash;
+        if (!(fields >> entry.id >> mode >> entry.file_size >> hash)) {
+            throw MtkLogoException("Invalid manifest line: " + line);
+        }
+        entry.mode = ImageUtils::parseColorMode(mode);
+        entry.file_hash = std::stoull(hash, nullptr, 16);
+        
+        std::getline(fields >> std::ws, entry.file);
+        entries.push_back(entry);
+    }
+    
+    // Hashes from another version cannot be compared, repack recompresses
+    if (version != MANIFEST_VERSION) {
+        throw MtkLogoException("Unsupported manifest version");
+    }
+}
+
+const ManifestEntry* ProjectManifest::findUnchanged(const std::string& path) const {
+    for (const auto& entry : entries) {
+        // Same name in another unpack directory is a different image
+        if (!isSameFile(dir_ + "/" + entry.file, path)) {
+            continue;
+        }
+        
+        uint64_t size = 0;
+        uint64_t hash = hashFile(path, &size);
+        return (size == entry.file_size && hash == entry.file_hash) ? &entry : nullptr;
+    }
+    
+    return nullptr;
+}
+
+bootmod::ByteSpan ProjectManifest::originalBlob(const ManifestEntry& entry) const {
+    return original_.blob(entry.id - 1);
+}
+
+} // namespace mtklogo
@@ -0,0 +1,703 @@
+/**
+ * @file server.cpp
+ * @brief Resident request server implementation
+ */
+
+#include "server.h"
+#include "bootmod.h"
+#include "json.h"
+#include "profile.h"
+#include "splash.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#ifndef _WIN32
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace bootmod {
+
+#ifndef _WIN32
+
+// Larger frames are refused, no request or image comes close
+static const uint32_t MAX_FRAME = 256u << 20;
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+// Closes the descriptor when it goes out of scope
+struct SocketHandle {
+    int fd;
+
+    explicit SocketHandle(int descriptor) : fd(descriptor) {}
+    ~SocketHandle() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+static bool readFull(int fd, void* buffer, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t n = recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void* buffer, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Read one frame, false at the end of the stream or on an oversized frame
+static bool readFrame(int fd, std::vector<uint8_t>& frame) {
+    uint8_t header[4];
+    if (!readFull(fd, header, sizeof(header))) {
+        return false;
+    }
+    uint32_t size = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    if (size > MAX_FRAME) {
+        return false;
+    }
+    frame.resize(size);
+    return size == 0 || readFull(fd, frame.data(), size);
+}
+
+static bool writeFrame(int fd, const uint8_t* data, size_t size) {
+    uint8_t header[4] = {
+        static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+        static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 24)
+    };
+    return writeFull(fd, header, sizeof(header)) && writeFull(fd, data, size);
+}
+
+static bool writeFrame(int fd, const std::string& text) {
+    return writeFrame(fd, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+// ============================================================================
+// Server State
+// ============================================================================
+
+// Identity of a file on disk, a mismatch means it was rewritten
+struct FileStamp {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    time_t mtime;
+    long mtime_ns;
+
+    explicit FileStamp(const struct stat& st)
+        : dev(st.st_dev), ino(st.st_ino), size(st.st_size), mtime(st.st_mtime),
+#ifdef __APPLE__
+          mtime_ns(st.st_mtimespec.tv_nsec) {}
+#else
+          mtime_ns(st.st_mtim.tv_nsec) {}
+#endif
+
+    bool operator==(const FileStamp& other) const {
+        return dev == other.dev && ino == other.ino && size == other.size &&
+               mtime == other.mtime && mtime_ns == other.mtime_ns;
+    }
+};
+
+// An image the server holds open
+struct OpenImage {
+    std::string path;                               // Resolved, key of the image
+    FileStamp stamp;
+    std::unique_ptr<mtklogo::LogoImageView> logo;
+    std::unique_ptr<splash::SplashImage> splash;
+    std::map<size_t, std::vector<uint8_t>> replaced;  // MTK blobs replaced since the last save
+    std::set<size_t> pending;                       // Slots replaced since the last save
+    std::string info;                               // describe() of the file on disk
+
+    explicit OpenImage(const FileStamp& file_stamp) : stamp(file_stamp) {}
+
+    size_t slotCount() const {
+        return logo ? logo->getLogoCount() : splash->getImageCount();
+    }
+};
+
+// Extracted slot kept for repeated requests
+struct CachedSlot {
+    std::vector<uint8_t> data;
+    uint64_t last_use;
+
+    CachedSlot() : last_use(0) {}
+};
+
+// Helper: Required member of a request
+static const JsonValue& requestField(const JsonValue& request, const char* name) {
+    const JsonValue* value = request.find(name);
+    if (!value) {
+        throw std::runtime_error(std::string("missing \"") + name + "\"");
+    }
+    return *value;
+}
+
+// Helper: Optional string member of a request
+static std::string requestString(const JsonValue& request, const char* name,
+                                 const std::string& fallback = std::string()) {
+    const JsonValue* value = request.find(name);
+    return value ? value->asString() : fallback;
+}
+
+// Helper: Absolute path with symlinks resolved, throws if the file is missing
+static std::string resolvePath(const std::string& file) {
+    char resolved[PATH_MAX];
+    if (!realpath(file.c_str(), resolved)) {
+        throw std::runtime_error("Cannot open file: " + file);
+    }
+    return resolved;
+}
+
+// Requests are handled one at a time under a single lock. Each is a few
+// milliseconds once its image is open, so clients rarely wait on each other.
+class Server {
+public:
+    explicit Server(const ServerOptions& options)
+        : options_(options), cache_bytes_(0), clock_(0), hits_(0), misses_(0) {}
+
+    // Reply to one request. Sets has_data if data goes out as a second frame
+    // and stop on a shutdown request. Throws on errors.
+    std::string handle(const JsonValue& request, std::vector<uint8_t>& data, bool& has_data, bool& stop);
+
+private:
+    OpenImage& image(const std::string& file);
+    void drop(const std::string& path);
+    void dropSlot(const std::string& path, size_t index);
+    bootmod::ByteSpan logoBlob(const OpenImage& open, size_t index) const;
+    std::vector<uint8_t> extractSlot(OpenImage& open, size_t index, const std::string& format,
+                                     mtklogo::ColorMode mode, const mtklogo::DeviceProfile* profile);
+    void evict();
+
+    void info(const JsonValue& request, JsonWriter& reply);
+    void extract(const JsonValue& request, JsonWriter& reply, std::vector<uint8_t>& data, bool& has_data);
+    void replace(const JsonValue& request, JsonWriter& reply);
+    void save(const JsonValue& request, JsonWriter& reply);
+
+    const ServerOptions& options_;
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<OpenImage>> images_;
+    std::map<std::string, CachedSlot> cache_;       // Key: path, index, format, mode, profile
+    size_t cache_bytes_;
+    uint64_t clock_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+OpenImage& Server::image(const std::string& file) {
+    std::string path = resolvePath(file);
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        throw std::runtime_error("Cannot open file: " + file);
+    }
+
+    FileStamp stamp(st);
+    auto it = images_.find(path);
+    if (it != images_.end()) {
+        if (it->second->stamp == stamp) {
+            return *it->second;
+        }
+        // Rewritten behind our back, everything derived from it is stale
+        drop(path);
+    }
+
+    std::unique_ptr<OpenImage> open(new OpenImage(stamp));
+    open->path = path;
+    FormatType format = detectFormat(path);
+    if (format == FormatType::OPPO_SPLASH) {
+        open->splash.reset(new splash::SplashImage());
+        if (!open->splash->load(path)) {
+            throw std::runtime_error("Failed to load splash.img");
+        }
+    } else if (format == FormatType::MTK_LOGO) {
+        open->logo.reset(new mtklogo::LogoImageView(mtklogo::LogoImageView::open(path)));
+    } else {
+        throw std::runtime_error("Unknown file format");
+    }
+
+    OpenImage& result = *open;
+    images_[path] = std::move(open);
+    return result;
+}
+
+void Server::drop(const std::string& path) {
+    images_.erase(path);
+
+    std::string prefix = path + "\n";
+    auto it = cache_.lower_bound(prefix);
+    while (it != cache_.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        cache_bytes_ -= it->second.data.size();
+        it = cache_.erase(it);
+    }
+}
+
+void Server::dropSlot(const std::string& path, size_t index) {
+    std::string prefix = path + "\n" + std::to_string(index) + "\n";
+    auto it = cache_.lower_bound(prefix);
+    while (it != cache_.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        cache_bytes_ -= it->second.data.size();
+        it = cache_.erase(it);
+    }
+}
+
+void Server::evict() {
+    // Least recently used first; the cache holds tens of entries, a scan is fine
+    while (cache_bytes_ > options_.cache_limit && !cache_.empty()) {
+        auto oldest = cache_.begin();
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            if (it->second.last_use < oldest->second.last_use) {
+                oldest = it;
+            }
+        }
+        cache_bytes_ -= oldest->second.data.size();
+        cache_.erase(oldest);
+    }
+}
+
+bootmod::ByteSpan Server::logoBlob(const OpenImage& open, size_t index) const {
+    auto replaced = open.replaced.find(index);
+    if (replaced != open.replaced.end()) {
+        return bootmod::ByteSpan(replaced->second.data(), replaced->second.size());
+    }
+    return open.logo->blob(index);
+}
+
+std::vector<uint8_t> Server::extractSlot(OpenImage& open, size_t index, const std::string& format,
+                                         mtklogo::ColorMode mode, const mtklogo::DeviceProfile* profile) {
+    if (format != "png" && format != "raw") {
+        throw std::runtime_error("Unknown format: " + format + " (png or raw)");
+    }
+
+    // Splash: raw is the inflated BMP
+    if (open.splash) {
+        if (format == "raw") {
+            uint32_t width, height;
+            std::vector<uint8_t> bmp = open.splash->getImageData(static_cast<uint32_t>(index), width, height);
+            if (bmp.empty()) {
+                throw std::runtime_error("Failed to decompress image");
+            }
+            return bmp;
+        }
+        std::vector<uint8_t> png;
+        if (!open.splash->extractImage(static_cast<uint32_t>(index), png)) {
+            throw std::runtime_error("Failed to extract image");
+        }
+        return png;
+    }
+
+    // MTK: raw is the zlib blob, as unpack --raw writes it
+    bootmod::ByteSpan blob = logoBlob(open, index);
+    if (format == "raw") {
+        return std::vector<uint8_t>(blob.begin(), blob.end());
+    }
+
+    // Same dimensions and PNG writer as unpack
+    std::vector<uint8_t> frame;
+    size_t size = mtklogo::ImageUtils::measureFrame(blob, frame);
+    mtklogo::Dimensions dimensions;
+    if (!profile || !profile->dimensionsFor(index + 1, size, mode, dimensions)) {
+        auto guesses = mtklogo::MtkLogo::guessDimensions(size, mode);
+        if (guesses.empty()) {
+            throw std::runtime_error("Cannot determine dimensions of " + std::to_string(size) + " bytes");
+        }
+        dimensions = guesses[0];
+    }
+    std::vector<uint8_t> png;
+    mtklogo::ImageUtils::inflateToPNG(blob, png, dimensions.first, dimensions.second, mode, frame);
+    return png;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+std::string Server::handle(const JsonValue& request, std::vector<uint8_t>& data, bool& has_data, bool& stop) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string& cmd = requestField(request, "cmd").asString();
+
+    JsonWriter reply;
+    reply.beginObject().field("ok", true);
+
+    if (cmd == "ping") {
+        // Nothing to do, lets clients wait for the server to come up
+    } else if (cmd == "info") {
+        info(request, reply);
+    } else if (cmd == "extract") {
+        extract(request, reply, data, has_data);
+    } else if (cmd == "replace") {
+        replace(request, reply);
+    } else if (cmd == "save") {
+        save(request, reply);
+    } else if (cmd == "close") {
+        std::string path = resolvePath(requestField(request, "file").asString());
+        reply.field("was_open", images_.count(path) > 0);
+        drop(path);
+    } else if (cmd == "stats") {
+        reply.field("open_files", images_.size())
+            .field("cached_slots", cache_.size())
+            .field("cache_bytes", cache_bytes_)
+            .field("cache_limit", options_.cache_limit)
+            .field("hits", hits_)
+            .field("misses", misses_);
+    } else if (cmd == "shutdown") {
+        stop = true;
+    } else {
+        throw std::runtime_error("Unknown cmd: " + cmd);
+    }
+
+    reply.endObject();
+    return reply.str();
+}
+
+void Server::info(const JsonValue& request, JsonWriter& reply) {
+    OpenImage& open = image(requestField(request, "file").asString());
+    bool cached = !open.info.empty();
+    if (!cached) {
+        open.info = options_.describe(open.path);
+        while (!open.info.empty() && open.info.back() == '\n') {
+            open.info.pop_back();
+        }
+    }
+
+    // The file as saved, replacements show up once they are saved
+    reply.field("cached", cached).field("pending", open.pending.size());
+    reply.key("info").raw(open.info);
+}
+
+void Server::extract(const JsonValue& request, JsonWriter& reply, std::vector<uint8_t>& data, bool& has_data) {
+    OpenImage& open = image(requestField(request, "file").asString());
+
+    // MTK slots count from 1, splash images from 0, as on the command line
+    uint64_t number = requestField(request, "index").asUnsigned();
+    size_t index = open.logo ? static_cast<size_t>(number) - 1 : static_cast<size_t>(number);
+    if ((open.logo && number == 0) || index >= open.slotCount()) {
+        throw std::runtime_error("Invalid index: " + std::to_string(number));
+    }
+
+    std::string format = requestString(request, "format", "png");
+    mtklogo::ColorMode mode = mtklogo::ImageUtils::parseColorMode(requestString(request, "mode", "bgrabe"));
+    std::string profile_name = requestString(request, "profile");
+    const mtklogo::DeviceProfile* profile = nullptr;
+    if (!profile_name.empty()) {
+        profile = mtklogo::ProfileDatabase::builtin().find(profile_name);
+        if (!profile) {
+            throw std::runtime_error("Unknown device profile: " + profile_name);
+        }
+    }
+
+    std::string key = open.path + "\n" + std::to_string(index) + "\n" + format + "\n" +
+                      (open.logo ? mtklogo::ImageUtils::getColorModeName(mode) : std::string()) +
+                      "\n" + profile_name;
+    auto it = cache_.find(key);
+    bool cached = it != cache_.end();
+    if (cached) {
+        hits_++;
+    } else {
+        CachedSlot slot;
+        slot.data = extractSlot(open, index, format, mode, profile);
+        cache_bytes_ += slot.data.size();
+        it = cache_.insert(std::make_pair(key, std::move(slot))).first;
+        // Only now, a request extractSlot() rejected was no miss
+        misses_++;
+    }
+    it->second.last_use = ++clock_;
+
+    const std::vector<uint8_t>& bytes = it->second.data;
+    reply.field("cached", cached).field("size", bytes.size());
+
+    std::string output = requestString(request, "output");
+    if (output.empty()) {
+        data = bytes;
+        has_data = true;
+        reply.field("data_size", data.size());
+    } else {
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {
+            throw std::runtime_error("Failed to write file: " + output);
+        }
+        reply.field("output", output);
+    }
+
+    evict();
+}
+
+void Server::replace(const JsonValue& request, JsonWriter& reply) {
+    OpenImage& open = image(requestField(request, "file").asString());
+    std::string png = requestField(request, "image").asString();
+
+    uint64_t number = requestField(request, "index").asUnsigned();
+    size_t index = open.logo ? static_cast<size_t>(number) - 1 : static_cast<size_t>(number);
+    if ((open.logo && number == 0) || index >= open.slotCount()) {
+        throw std::runtime_error("Invalid index: " + std::to_string(number));
+    }
+
+    if (open.splash) {
+        if (!open.splash->replaceImage(static_cast<uint32_t>(index), png)) {
+            throw std::runtime_error("Failed to replace image");
+        }
+    } else {
+        mtklogo::ColorMode mode = mtklogo::ImageUtils::parseColorMode(requestString(request, "mode", "bgrabe"));
+        uint32_t width = 0, height = 0;
+        std::vector<uint8_t> pixels = mtklogo::ImageUtils::loadFromPNG(png, width, height, mode);
+        open.replaced[index] = mtklogo::ImageUtils::zlibCompress(pixels, 9);
+    }
+
+    open.pending.insert(index);
+    dropSlot(open.path, index);
+    reply.field("pending", open.pending.size());
+}
+
+void Server::save(const JsonValue& request, JsonWriter& reply) {
+    OpenImage& open = image(requestField(request, "file").asString());
+    std::string output = requestString(request, "output", open.path);
+
+    struct stat st;
+    bool in_place = stat(output.c_str(), &st) == 0 && FileStamp(st).ino == open.stamp.ino &&
+                    FileStamp(st).dev == open.stamp.dev;
+
+    if (open.splash) {
+        if (!open.splash->save(output)) {
+            throw std::runtime_error("Failed to save splash.img");
+        }
+    } else {
+        // The view maps the file being replaced, the writer renames a
+        // temporary file over it so the mapping stays intact
+        mtklogo::LogoImageWriter writer(output, open.slotCount());
+        for (size_t i = 0; i < open.slotCount(); i++) {
+            bootmod::ByteSpan blob = logoBlob(open, i);
+            writer.append(blob.data, blob.size);
+        }
+        writer.finish();
+    }
+
+    reply.field("output", output).field("in_place", in_place).field("saved", open.pending.size());
+
+    // The replacements now live in output, a later save must not write them
+    // again. The image is reopened from disk on the next request, which also
+    // picks up an in-place save. drop() frees open, copy the key first.
+    std::string path = open.path;
+    drop(path);
+}
+
+// ============================================================================
+// Socket Loop
+// ============================================================================
+
+static volatile sig_atomic_t signalled = 0;
+
+static void onSignal(int) {
+    signalled = 1;
+}
+
+// Helper: Socket address for a path, throws if the path is too long
+static sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+// Helper: Answer requests on one connection until the client hangs up
+static void serveConnection(Server& server, int fd, std::atomic<bool>& stopping) {
+    std::vector<uint8_t> frame;
+    while (readFrame(fd, frame)) {
+        std::vector<uint8_t> data;
+        bool has_data = false;
+        bool stop = false;
+        std::string reply;
+        try {
+            JsonValue request = JsonValue::parse(std::string(frame.begin(), frame.end()));
+            reply = server.handle(request, data, has_data, stop);
+        } catch (const std::exception& e) {
+            JsonWriter w;
+            w.beginObject().field("ok", false).field("error", e.what()).endObject();
+            reply = w.str();
+            has_data = false;
+        }
+
+        if (!writeFrame(fd, reply) || (has_data && !writeFrame(fd, data.data(), data.size()))) {
+            return;
+        }
+        if (stop) {
+            stopping = true;
+            return;
+        }
+    }
+}
+
+int runServer(const ServerOptions& options) {
+    try {
+        sockaddr_un address = socketAddress(options.socket_path);
+
+        // A socket file nobody answers on is left over from a server that died
+        struct stat st;
+        if (stat(options.socket_path.c_str(), &st) == 0) {
+            SocketHandle probe(socket(AF_UNIX, SOCK_STREAM, 0));
+            if (connect(probe.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+                throw std::runtime_error("A server is already listening on " + options.socket_path);
+            }
+            if (!S_ISSOCK(st.st_mode)) {
+                throw std::runtime_error("Not a socket: " + options.socket_path);
+            }
+            unlink(options.socket_path.c_str());
+        }
+
+        // Only the owner may talk to it. The socket file gets its mode from
+        // the umask at bind(), a chmod afterwards would leave a window open.
+        SocketHandle listener(socket(AF_UNIX, SOCK_STREAM, 0));
+        bool bound = false;
+        if (listener.fd >= 0) {
+            mode_t old_mask = umask(0077);
+            bound = bind(listener.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+            int bind_errno = errno;
+            umask(old_mask);
+            errno = bind_errno;
+        }
+        if (!bound || listen(listener.fd, 16) != 0) {
+            throw std::runtime_error("Cannot listen on " + options.socket_path + ": " + strerror(errno));
+        }
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = onSignal;
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        signal(SIGPIPE, SIG_IGN);
+
+        printf("Listening on %s\n", options.socket_path.c_str());
+        fflush(stdout);
+
+        Server server(options);
+        std::atomic<bool> stopping(false);
+        std::mutex clients_mutex;
+        std::condition_variable clients_done;
+        std::set<int> clients;
+
+        while (!stopping && !signalled) {
+            pollfd ready;
+            ready.fd = listener.fd;
+            ready.events = POLLIN;
+            ready.revents = 0;
+            if (poll(&ready, 1, 200) <= 0) {
+                continue;
+            }
+
+            int fd = accept(listener.fd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(clients_mutex);
+            clients.insert(fd);
+            std::thread([&, fd]() {
+                serveConnection(server, fd, stopping);
+                std::lock_guard<std::mutex> lock(clients_mutex);
+                clients.erase(fd);
+                close(fd);
+                clients_done.notify_all();
+            }).detach();
+        }
+
+        // Wake connections blocked in recv, their threads close them
+        std::unique_lock<std::mutex> lock(clients_mutex);
+        for (int fd : clients) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        clients_done.wait(lock, [&]() { return clients.empty(); });
+
+        unlink(options.socket_path.c_str());
+        printf("Server stopped\n");
+        return 0;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+}
+
+std::string callServer(const std::string& socket_path, const std::string& request,
+                       std::vector<uint8_t>* data) {
+    sockaddr_un address = socketAddress(socket_path);
+    SocketHandle connection(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (connection.fd < 0 ||
+        connect(connection.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Cannot connect to " + socket_path + ": " + strerror(errno));
+    }
+
+    std::vector<uint8_t> frame;
+    if (!writeFrame(connection.fd, request) || !readFrame(connection.fd, frame)) {
+        throw std::runtime_error("Server closed the connection");
+    }
+    std::string reply(frame.begin(), frame.end());
+
+    if (JsonValue::parse(reply).find("data_size")) {
+        if (!readFrame(connection.fd, frame)) {
+            throw std::runtime_error("Server closed the connection");
+        }
+        if (data) {
+            data->swap(frame);
+        }
+    }
+    return reply;
+}
+
+#else // _WIN32
+
+int runServer(const ServerOptions&) {
+    fprintf(stderr, "Error: serve needs Unix domain sockets, not available on Windows\n");
+    return 1;
+}
+
+std::string callServer(const std::string&, const std::string&, std::vector<uint8_t>*) {
+    throw std::runtime_error("Unix domain sockets are not available on Windows");
+}
+
+#endif // _WIN32
+
+} // namespace bootmod
@@ -4,10 +4,24 @@
  */
 
 #include "splash.h"
+#include "bootmod.h"
+#include "checksum.h"
+#include "codec.h"
+#include "stats.h"
+#include "thread_pool.h"
 #include "../external/lodepng/lodepng.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace bootmod {
 namespace splash {
@@ -16,7 +30,8 @@ SplashImage::SplashImage()
     : has_ddph_(false)
     , image_count_(0)
     , width_(0)
-    , height_(0) {
+    , height_(0)
+    , log_(nullptr) {
     memset(&ddph_header_, 0, sizeof(ddph_header_));
     memset(&splash_header_, 0, sizeof(splash_header_));
 }
@@ -39,26 +54,34 @@ bool SplashImage::isValidSplash(const std::string& filename) {
 }
 
 bool SplashImage::load(const std::string& filename) {
+    StageTimer timer(Stage::READ);
     filename_ = filename;
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << filename << std::endl;
+    if (!file_.open(filename)) {
+        report("Failed to open file: " + filename);
         return false;
     }
     
+    const uint8_t* data = file_.data();
+    size_t size = file_.size();
+    
     // Check for DDPH header
-    file.seekg(DDPH_HDR_OFFSET);
-    file.read(reinterpret_cast<char*>(&ddph_header_), sizeof(ddph_header_));
+    memset(&ddph_header_, 0, sizeof(ddph_header_));
+    if (size >= DDPH_HDR_OFFSET + sizeof(ddph_header_)) {
+        memcpy(&ddph_header_, data + DDPH_HDR_OFFSET, sizeof(ddph_header_));
+    }
     has_ddph_ = (ddph_header_.magic == DDPH_MAGIC_V1);
     
     // Read OPPO_SPLASH header
-    file.seekg(OPPO_SPLASH_HDR_OFFSET);
-    file.read(reinterpret_cast<char*>(&splash_header_), sizeof(splash_header_));
+    if (size < OPPO_SPLASH_HDR_OFFSET + sizeof(splash_header_)) {
+        report("Invalid splash.img magic");
+        return false;
+    }
+    memcpy(&splash_header_, data + OPPO_SPLASH_HDR_OFFSET, sizeof(splash_header_));
     
     // Validate magic
     if (memcmp(splash_header_.magic, OPPO_SPLASH_MAGIC, 12) != 0) {
-        std::cerr << "Invalid splash.img magic" << std::endl;
+        report("Invalid splash.img magic");
         return false;
     }
     
@@ -67,27 +90,63 @@ bool SplashImage::load(const std::string& filename) {
     height_ = splash_header_.height;
     
     // Read metadata
-    file.seekg(METADATA_OFFSET);
-    metadata_.resize(image_count_);
-    for (uint32_t i = 0; i < image_count_; i++) {
-        file.read(reinterpret_cast<char*>(&metadata_[i]), sizeof(splash_metadata_hdr_t));
+    if (METADATA_OFFSET + static_cast<uint64_t>(image_count_) * sizeof(splash_metadata_hdr_t) > size) {
+        report("Splash metadata exceeds file size");
+        return false;
     }
+    metadata_.resize(image_count_);
+    memcpy(metadata_.data(), data + METADATA_OFFSET, image_count_ * sizeof(splash_metadata_hdr_t));
+    file_metadata_ = metadata_;
     
-    // Read compressed image data
+    // Point at compressed image data inside the mapping
     image_data_.resize(image_count_);
+    replaced_.assign(image_count_, std::vector<uint8_t>());
+    geometry_.assign(image_count_, BmpGeometry());
     for (uint32_t i = 0; i < image_count_; i++) {
-        file.seekg(DATA_OFFSET + metadata_[i].offset);
-        image_data_[i].resize(metadata_[i].compsz);
-        file.read(reinterpret_cast<char*>(image_data_[i].data()), metadata_[i].compsz);
+        uint64_t start = DATA_OFFSET + static_cast<uint64_t>(metadata_[i].offset);
+        if (start + metadata_[i].compsz > size) {
+            report("Image " + std::to_string(i) + " exceeds file size");
+            return false;
+        }
+        image_data_[i] = file_.span(start, metadata_[i].compsz);
     }
     
     return true;
 }
 
+// Helper: True if both paths name the same existing file. Windows reads the
+// file into memory instead of mapping it, so overwriting is always safe there.
+static bool isSameFile(const std::string& a, const std::string& b) {
+#ifdef _WIN32
+    (void)a;
+    (void)b;
+    return false;
+#else
+    struct stat sa, sb;
+    if (stat(a.c_str(), &sa) != 0 || stat(b.c_str(), &sb) != 0) {
+        return false;
+    }
+    return sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+#endif
+}
+
 bool SplashImage::save(const std::string& filename) {
-    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    StageTimer timer(Stage::WRITE);
+    
+    // Untouched images are written straight from the mapping, so the
+    // loaded file must not be truncated while we still read from it
+    bool in_place = file_.isOpen() && isSameFile(filename, filename_);
+    if (in_place && canPatch()) {
+        size_t written = 0;
+        bool patched = savePatch(&written);
+        countBytes(0, written);
+        return patched;
+    }
+    std::string target = in_place ? filename + ".tmp" : filename;
+    
+    std::ofstream file(target, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
-        std::cerr << "Failed to create file: " << filename << std::endl;
+        report("Failed to create file: " + target);
         return false;
     }
     
@@ -101,7 +160,7 @@ bool SplashImage::save(const std::string& filename) {
     uint32_t current_offset = 0;
     for (uint32_t i = 0; i < image_count_; i++) {
         metadata_[i].offset = current_offset;
-        metadata_[i].compsz = image_data_[i].size();
+        metadata_[i].compsz = image_data_[i].size;
         current_offset += metadata_[i].compsz;
     }
     
@@ -118,12 +177,151 @@ bool SplashImage::save(const std::string& filename) {
     // Write compressed image data
     for (uint32_t i = 0; i < image_count_; i++) {
         file.seekp(DATA_OFFSET + metadata_[i].offset);
-        file.write(reinterpret_cast<const char*>(image_data_[i].data()), image_data_[i].size());
+        file.write(reinterpret_cast<const char*>(image_data_[i].data), image_data_[i].size);
+    }
+    
+    file.close();
+    if (!file) {
+        report("Failed to write file: " + target);
+        std::remove(target.c_str());
+        return false;
+    }
+    countBytes(0, DATA_OFFSET + current_offset);
+    
+    // The old mapping stays valid after the rename, it keeps the replaced inode
+    if (in_place && std::rename(target.c_str(), filename.c_str()) != 0) {
+        report("Failed to replace file: " + filename);
+        std::remove(target.c_str());
+        return false;
     }
     
     return true;
 }
 
+// Images must sit in index order without overlapping for their slots to be
+// known. pwrite is POSIX only, Windows always rewrites the whole file.
+bool SplashImage::canPatch() const {
+#ifdef _WIN32
+    return false;
+#else
+    if (!file_.isOpen() || file_metadata_.size() != image_count_) {
+        return false;
+    }
+    for (uint32_t i = 0; i + 1 < image_count_; i++) {
+        if (static_cast<uint64_t>(file_metadata_[i].offset) + file_metadata_[i].compsz >
+            file_metadata_[i + 1].offset) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+bool SplashImage::savePatch(size_t* bytes_written) {
+    if (bytes_written) {
+        *bytes_written = 0;
+    }
+    if (!canPatch()) {
+        report("Cannot patch " + filename_ + " in place");
+        return false;
+    }
+    
+#ifdef _WIN32
+    return false;
+#else
+    // New layout: images keep their slot until one outgrows it (the last
+    // image may always grow), everything from there on is packed behind it
+    std::vector<uint32_t> offsets(image_count_);
+    std::vector<bool> rewrite(image_count_);
+    bool relocating = false;
+    uint64_t next_offset = 0;
+    for (uint32_t i = 0; i < image_count_; i++) {
+        uint64_t size = image_data_[i].size;
+        if (!relocating) {
+            uint64_t slot_end = (i + 1 < image_count_) ? file_metadata_[i + 1].offset : UINT64_MAX;
+            if (file_metadata_[i].offset + size <= slot_end) {
+                offsets[i] = file_metadata_[i].offset;
+                rewrite[i] = !replaced_[i].empty();
+                continue;
+            }
+            relocating = true;
+            next_offset = file_metadata_[i].offset;
+        }
+        if (next_offset + size > UINT32_MAX) {
+            report("Splash image too large");
+            return false;
+        }
+        offsets[i] = static_cast<uint32_t>(next_offset);
+        rewrite[i] = true;
+        next_offset += size;
+    }
+    
+    // Moved images are read from the mapping, copy them out before any
+    // write can land on top of them
+    std::vector<std::vector<uint8_t>> moved(image_count_);
+    for (uint32_t i = 0; i < image_count_; i++) {
+        if (rewrite[i] && replaced_[i].empty()) {
+            moved[i].assign(image_data_[i].begin(), image_data_[i].end());
+        }
+    }
+    
+    int fd = ::open(filename_.c_str(), O_WRONLY);
+    if (fd < 0) {
+        report("Failed to open file for writing: " + filename_);
+        return false;
+    }
+    
+    size_t written = 0;
+    auto writeAt = [&](const void* data, size_t size, uint64_t offset) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            ssize_t n = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            bytes += n;
+            size -= n;
+            offset += n;
+            written += n;
+        }
+        return true;
+    };
+    
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < image_count_; i++) {
+        metadata_[i].offset = offsets[i];
+        metadata_[i].compsz = image_data_[i].size;
+        if (rewrite[i]) {
+            const uint8_t* data = moved[i].empty() ? replaced_[i].data() : moved[i].data();
+            ok = writeAt(data, image_data_[i].size, DATA_OFFSET + static_cast<uint64_t>(offsets[i]));
+        }
+    }
+    
+    // Metadata last, once every image it points at is written
+    if (ok) {
+        ok = writeAt(metadata_.data(), image_count_ * sizeof(splash_metadata_hdr_t), METADATA_OFFSET);
+    }
+    
+    if (::close(fd) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        report("Failed to write file: " + filename_);
+        return false;
+    }
+    
+    if (bytes_written) {
+        *bytes_written = written;
+    }
+    
+    // Map the patched file again, replaced images now live in it
+    return load(filename_);
+#endif
+}
+
 ImageInfo SplashImage::getImageInfo(uint32_t index) const {
     ImageInfo info;
     
@@ -132,8 +330,11 @@ ImageInfo SplashImage::getImageInfo(uint32_t index) const {
     }
     
     info.name = std::string(reinterpret_cast<const char*>(metadata_[index].name));
-    info.width = width_;
-    info.height = height_;
+    
+    BmpGeometry geometry = bmpGeometry(index);
+    info.width = geometry.valid ? geometry.width : width_;
+    info.height = geometry.valid ? geometry.height : height_;
+    info.bpp = geometry.bpp;
     info.offset = metadata_[index].offset;
     info.compressed_size = metadata_[index].compsz;
     info.uncompressed_size = metadata_[index].realsz;
@@ -141,59 +342,128 @@ ImageInfo SplashImage::getImageInfo(uint32_t index) const {
     return info;
 }
 
-bool SplashImage::decompressImage(uint32_t index, std::vector<uint8_t>& output) {
-    if (index >= image_count_) {
+SplashImage::BmpGeometry SplashImage::bmpGeometry(uint32_t index) const {
+    std::lock_guard<std::mutex> lock(geometry_mutex_);
+    BmpGeometry& geometry = geometry_[index];
+    if (geometry.probed) {
+        return geometry;
+    }
+    geometry.probed = true;
+    
+    // File header (14 bytes) and info header (40 bytes). A broken image
+    // falls back to the header size; extracting it reports the error.
+    std::vector<uint8_t> header;
+    std::string error;
+    if (peekImage(index, 54, header, &error) && header.size() == 54 && header[0] == 'B' && header[1] == 'M') {
+        memcpy(&geometry.width, &header[18], 4);
+        memcpy(&geometry.height, &header[22], 4);
+        memcpy(&geometry.bpp, &header[28], 2);
+        geometry.valid = true;
+    }
+    return geometry;
+}
+
+bool SplashImage::report(const std::string& message) const {
+    if (log_) {
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        log_->append(message).append("\n");
+    } else {
+        std::cerr << message << std::endl;
+    }
+    return false;
+}
+
+bool SplashImage::fail(std::string* error, const std::string& message) const {
+    if (error) {
+        *error = message;
         return false;
     }
+    return report(message);
+}
+
+// Raw deflate stream of a gzip member, without its header (10 bytes) and
+// footer (8 bytes)
+bool SplashImage::deflateStream(bootmod::ByteSpan compressed, bootmod::ByteSpan& stream,
+                                std::string* error) const {
+    if (compressed.size < 18) {
+        return fail(error, "Compressed data too small");
+    }
     
-    // Skip gzip header (10 bytes) and footer (8 bytes)
-    const std::vector<uint8_t>& compressed = image_data_[index];
-    if (compressed.size() < 18) {
-        std::cerr << "Compressed data too small" << std::endl;
+    stream = bootmod::ByteSpan(compressed.data + 10, compressed.size - 18);
+    return true;
+}
+
+bool SplashImage::decompressImage(uint32_t index, std::vector<uint8_t>& output,
+                                  std::string* error) const {
+    bootmod::ByteSpan stream;
+    if (index >= image_count_ || !deflateStream(image_data_[index], stream, error)) {
         return false;
     }
     
-    const uint8_t* gzip_data = compressed.data() + 10;
-    size_t gzip_size = compressed.size() - 18;
+    // Gzip footer carries the uncompressed size, size the output up front
+    const bootmod::ByteSpan& compressed = image_data_[index];
+    uint32_t isize = 0;
+    memcpy(&isize, compressed.data + compressed.size - 4, 4);
+    output.clear();
+    if (isize <= stream.size * 1032) {  // deflate can't expand beyond ~1032:1
+        output.reserve(isize);
+    }
     
-    // Decompress using lodepng inflate (raw deflate without zlib header)
-    size_t output_size = 0;
-    unsigned char* decompressed = nullptr;
+    // Raw deflate stream, no zlib header
+    try {
+        bootmod::CodecContext::forThread().inflate(stream, output, bootmod::DeflateFormat::RAW);
+    } catch (const std::exception& e) {
+        return fail(error, std::string("Decompression failed: ") + e.what());
+    }
     
-    // Use lodepng_inflate which handles raw deflate stream
-    LodePNGDecompressSettings settings;
-    lodepng_decompress_settings_init(&settings);
+    return true;
+}
+
+bool SplashImage::probeImage(uint32_t index, size_t& size) const {
+    bootmod::ByteSpan stream;
+    if (index >= image_count_ || !deflateStream(image_data_[index], stream)) {
+        return false;
+    }
     
-    unsigned error = lodepng_inflate(&decompressed, &output_size, 
-                                     gzip_data, gzip_size, &settings);
+    try {
+        size = bootmod::CodecContext::forThread().inflatedSize(stream, bootmod::DeflateFormat::RAW);
+    } catch (const std::exception& e) {
+        report(std::string("Decompression failed: ") + e.what());
+        return false;
+    }
     
-    if (error) {
-        std::cerr << "Decompression failed: " << lodepng_error_text(error) << std::endl;
+    return true;
+}
+
+bool SplashImage::peekImage(uint32_t index, size_t count, std::vector<uint8_t>& output,
+                            std::string* error) const {
+    bootmod::ByteSpan stream;
+    if (index >= image_count_ || !deflateStream(image_data_[index], stream, error)) {
         return false;
     }
     
-    output.assign(decompressed, decompressed + output_size);
-    free(decompressed);
+    output.resize(count);
+    try {
+        output.resize(bootmod::CodecContext::forThread().inflatePeek(
+            stream, output.data(), count, bootmod::DeflateFormat::RAW));
+    } catch (const std::exception& e) {
+        return fail(error, std::string("Decompression failed: ") + e.what());
+    }
     
     return true;
 }
 
 bool SplashImage::compressImage(const std::vector<uint8_t>& input, 
                                 std::vector<uint8_t>& output) {
-    // Compress using lodepng deflate (raw deflate without zlib header)
-    unsigned char* compressed = nullptr;
-    size_t compressed_size = 0;
-    
-    LodePNGCompressSettings settings;
-    lodepng_compress_settings_init(&settings);
-    
-    unsigned error = lodepng_deflate(&compressed, &compressed_size,
-                                     input.data(), input.size(), &settings);
-    
-    if (error) {
-        std::cerr << "Compression failed: " << lodepng_error_text(error) << std::endl;
+    // Compress to raw deflate (no zlib wrapper to strip)
+    std::vector<uint8_t> compressed;
+    try {
+        bootmod::CodecContext::forThread().deflate(input, compressed, 9, bootmod::DeflateFormat::RAW);
+    } catch (const std::exception& e) {
+        report(std::string("Compression failed: ") + e.what());
         return false;
     }
+    size_t compressed_size = compressed.size();
     
     // Build gzip format: header + deflate data + footer
     output.clear();
@@ -213,11 +483,15 @@ bool SplashImage::compressImage(const std::vector<uint8_t>& input,
                   reinterpret_cast<uint8_t*>(&header),
                   reinterpret_cast<uint8_t*>(&header) + 10);
     
-    // Insert raw deflate data (no zlib wrapper to strip)
-    output.insert(output.end(), compressed, compressed + compressed_size);
+    // Insert raw deflate data
+    output.insert(output.end(), compressed.begin(), compressed.end());
     
     // Calculate CRC32 and size for gzip footer
-    uint32_t crc = lodepng_crc32(input.data(), input.size());
+    uint32_t crc;
+    {
+        StageTimer timer(Stage::HASH);
+        crc = bootmod::checksum::crc32(0, bootmod::ByteSpan(input.data(), input.size()));
+    }
     uint32_t isize = static_cast<uint32_t>(input.size());
     
     output.insert(output.end(), 
@@ -227,13 +501,12 @@ bool SplashImage::compressImage(const std::vector<uint8_t>& input,
                   reinterpret_cast<uint8_t*>(&isize),
                   reinterpret_cast<uint8_t*>(&isize) + 4);
     
-    free(compressed);
     return true;
 }
 
 std::vector<uint8_t> SplashImage::getImageData(uint32_t index, 
                                                 uint32_t& width, 
-                                                uint32_t& height) {
+                                                uint32_t& height) const {
     std::vector<uint8_t> bmp_data;
     
     if (!decompressImage(index, bmp_data)) {
@@ -242,7 +515,7 @@ std::vector<uint8_t> SplashImage::getImageData(uint32_t index,
     
     // BMP header is 54 bytes (14 + 40)
     if (bmp_data.size() < 54) {
-        std::cerr << "Invalid BMP data" << std::endl;
+        report("Invalid BMP data");
         return std::vector<uint8_t>();
     }
     
@@ -253,22 +526,73 @@ std::vector<uint8_t> SplashImage::getImageData(uint32_t index,
     return bmp_data;
 }
 
-bool SplashImage::extractImage(uint32_t index, const std::string& output_path) {
-    if (index >= image_count_) {
-        std::cerr << "Invalid image index: " << index << std::endl;
+// Decode buffers of one thread, kept between images so extracting a
+// whole splash.img allocates once per thread
+struct ExtractBuffers {
+    std::vector<uint8_t> bmp;
+    std::vector<uint8_t> rgba;
+    std::vector<uint8_t> png;
+};
+
+static ExtractBuffers& extractBuffers() {
+    static thread_local ExtractBuffers buffers;
+    return buffers;
+}
+
+bool SplashImage::extractImage(uint32_t index, const std::string& output_path) const {
+    std::string error;
+    if (!extractImage(index, output_path, error)) {
+        report(error);
+        return false;
+    }
+    return true;
+}
+
+bool SplashImage::extractImage(uint32_t index, std::vector<uint8_t>& png) const {
+    std::string error;
+    if (!encodeImage(index, png, error)) {
+        report(error);
+        return false;
+    }
+    return true;
+}
+
+bool SplashImage::extractImage(uint32_t index, const std::string& output_path,
+                               std::string& error) const {
+    std::vector<uint8_t>& png = extractBuffers().png;
+    if (!encodeImage(index, png, error)) {
         return false;
     }
     
+    bool saved;
+    {
+        StageTimer timer(Stage::WRITE);
+        saved = lodepng::save_file(png, output_path) == 0;
+    }
+    if (!saved) {
+        return fail(&error, "Failed to write file: " + output_path);
+    }
+    countBytes(0, png.size());
+    return true;
+}
+
+bool SplashImage::encodeImage(uint32_t index, std::vector<uint8_t>& png, std::string& error) const {
+    if (index >= image_count_) {
+        return fail(&error, "Invalid image index: " + std::to_string(index));
+    }
+    
+    countBytes(image_data_[index].size, 0);
+    
     // Decompress BMP data
-    std::vector<uint8_t> bmp_data;
-    if (!decompressImage(index, bmp_data)) {
+    ExtractBuffers& buffers = extractBuffers();
+    std::vector<uint8_t>& bmp_data = buffers.bmp;
+    if (!decompressImage(index, bmp_data, &error)) {
         return false;
     }
     
     // Parse BMP and convert to PNG
     if (bmp_data.size() < 54) {
-        std::cerr << "Invalid BMP data" << std::endl;
-        return false;
+        return fail(&error, "Invalid BMP data");
     }
     
     uint32_t width = *reinterpret_cast<uint32_t*>(&bmp_data[18]);
@@ -276,96 +600,288 @@ bool SplashImage::extractImage(uint32_t index, const std::string& output_path) {
     uint16_t bpp = *reinterpret_cast<uint16_t*>(&bmp_data[28]);
     uint32_t offset = *reinterpret_cast<uint32_t*>(&bmp_data[10]);  // Pixel data offset
     
-    std::vector<uint8_t> rgba(width * height * 4);
-    
-    if (bpp == 8) {
-        // 8-bit indexed color - palette at offset 54, pixel data at 'offset'
-        if (bmp_data.size() < offset || bmp_data.size() < 54 + 256 * 4) {
-            std::cerr << "Invalid 8-bit BMP data" << std::endl;
-            return false;
-        }
-        
-        const uint8_t* palette = bmp_data.data() + 54;  // 256 colors * 4 bytes (BGRA)
-        const uint8_t* bmp_pixels = bmp_data.data() + offset;
-        int row_size = ((width + 3) / 4) * 4;  // Row size with padding
+    // BMP rows are stored bottom-up in BGR(A) order
+    std::vector<uint8_t>& rgba = buffers.rgba;
+    {
+        StageTimer timer(Stage::CONVERT);
+        rgba.resize(width * height * 4);
         
-        for (uint32_t y = 0; y < height; y++) {
-            const uint8_t* src_row = bmp_pixels + (height - 1 - y) * row_size;
-            uint8_t* dst_row = rgba.data() + y * width * 4;
+        if (bpp == 8) {
+            // 8-bit indexed color - palette at offset 54, pixel data at 'offset'
+            if (bmp_data.size() < offset || bmp_data.size() < 54 + 256 * 4) {
+                return fail(&error, "Invalid 8-bit BMP data");
+            }
             
-            for (uint32_t x = 0; x < width; x++) {
-                uint8_t index = src_row[x];
-                const uint8_t* color = palette + index * 4;
-                dst_row[x * 4 + 0] = color[2];  // R = B
-                dst_row[x * 4 + 1] = color[1];  // G = G
-                dst_row[x * 4 + 2] = color[0];  // B = R
-                dst_row[x * 4 + 3] = 255;       // A
+            const uint8_t* palette = bmp_data.data() + 54;  // 256 colors * 4 bytes (BGRA)
+            const uint8_t* bmp_pixels = bmp_data.data() + offset;
+            int row_size = ((width + 3) / 4) * 4;  // Row size with padding
+            
+            for (uint32_t y = 0; y < height; y++) {
+                const uint8_t* src_row = bmp_pixels + (height - 1 - y) * row_size;
+                uint8_t* dst_row = rgba.data() + y * width * 4;
+                
+                for (uint32_t x = 0; x < width; x++) {
+                    uint8_t index = src_row[x];
+                    const uint8_t* color = palette + index * 4;
+                    dst_row[x * 4 + 0] = color[2];  // R = B
+                    dst_row[x * 4 + 1] = color[1];  // G = G
+                    dst_row[x * 4 + 2] = color[0];  // B = R
+                    dst_row[x * 4 + 3] = 255;       // A
+                }
             }
-        }
-    } else if (bpp == 24 || bpp == 32) {
-        // 24-bit or 32-bit true color
-        const uint8_t* bmp_pixels = bmp_data.data() + offset;
-        int bytes_per_pixel = bpp / 8;
-        int row_size = ((width * bytes_per_pixel + 3) / 4) * 4;  // Row size with padding
-        
-        for (uint32_t y = 0; y < height; y++) {
-            const uint8_t* src_row = bmp_pixels + (height - 1 - y) * row_size;
-            uint8_t* dst_row = rgba.data() + y * width * 4;
+        } else if (bpp == 24 || bpp == 32) {
+            // 24-bit or 32-bit true color
+            const uint8_t* bmp_pixels = bmp_data.data() + offset;
+            int bytes_per_pixel = bpp / 8;
+            int row_size = ((width * bytes_per_pixel + 3) / 4) * 4;  // Row size with padding
             
-            for (uint32_t x = 0; x < width; x++) {
-                dst_row[x * 4 + 0] = src_row[x * bytes_per_pixel + 2];  // R = B
-                dst_row[x * 4 + 1] = src_row[x * bytes_per_pixel + 1];  // G = G
-                dst_row[x * 4 + 2] = src_row[x * bytes_per_pixel + 0];  // B = R
+            for (uint32_t y = 0; y < height; y++) {
+                const uint8_t* src_row = bmp_pixels + (height - 1 - y) * row_size;
+                uint8_t* dst_row = rgba.data() + y * width * 4;
                 
-                // Handle alpha: 32-bit BMPs store alpha, but BMP viewers typically ignore it
-                // Splash screens are meant to be displayed opaque, so force alpha=255 for all pixels with alpha=0
-                uint8_t alpha = (bpp == 32) ? src_row[x * bytes_per_pixel + 3] : 255;
-                if (bpp == 32 && alpha == 0) {
-                    alpha = 255;  // Force opaque - splash screens don't use transparency
+                for (uint32_t x = 0; x < width; x++) {
+                    dst_row[x * 4 + 0] = src_row[x * bytes_per_pixel + 2];  // R = B
+                    dst_row[x * 4 + 1] = src_row[x * bytes_per_pixel + 1];  // G = G
+                    dst_row[x * 4 + 2] = src_row[x * bytes_per_pixel + 0];  // B = R
+                    
+                    // Handle alpha: 32-bit BMPs store alpha, but BMP viewers typically ignore it
+                    // Splash screens are meant to be displayed opaque, so force alpha=255 for all pixels with alpha=0
+                    uint8_t alpha = (bpp == 32) ? src_row[x * bytes_per_pixel + 3] : 255;
+                    if (bpp == 32 && alpha == 0) {
+                        alpha = 255;  // Force opaque - splash screens don't use transparency
+                    }
+                    dst_row[x * 4 + 3] = alpha;
                 }
-                dst_row[x * 4 + 3] = alpha;
             }
+        } else {
+            return fail(&error, "Unsupported BMP bit depth: " + std::to_string(bpp) +
+                                "-bit (supported: 8, 24, 32)");
         }
-    } else {
-        std::cerr << "Unsupported BMP bit depth: " << bpp << "-bit (supported: 8, 24, 32)" << std::endl;
-        return false;
     }
     
     // Encode to PNG
-    unsigned error = lodepng::encode(output_path, rgba, width, height);
-    if (error) {
-        std::cerr << "PNG encoding failed: " << lodepng_error_text(error) << std::endl;
-        return false;
+    png.clear();
+    unsigned status;
+    {
+        StageTimer timer(Stage::PNG_ENCODE);
+        status = lodepng::encode(png, rgba, width, height);
+    }
+    if (status) {
+        return fail(&error, std::string("PNG encoding failed: ") + lodepng_error_text(status));
     }
     
     return true;
 }
 
+bool SplashImage::extractAll(const std::function<std::string(uint32_t)>& output_path,
+                             size_t jobs,
+                             const std::function<void(uint32_t, bool)>& progress,
+                             std::vector<SlotStats>* stats) const {
+    std::unique_ptr<ThreadPool> pool;
+    if (jobs == 0) {
+        jobs = ThreadPool::defaultThreadCount();
+    }
+    if (jobs > 1) {
+        pool.reset(new ThreadPool(jobs));
+    }
+    return extractOn(pool.get(), output_path, progress, stats);
+}
+
+bool SplashImage::extractAll(const std::function<std::string(uint32_t)>& output_path,
+                             ThreadPool& pool,
+                             const std::function<void(uint32_t, bool)>& progress,
+                             std::vector<SlotStats>* stats) const {
+    return extractOn(&pool, output_path, progress, stats);
+}
+
+bool SplashImage::extractOn(ThreadPool* pool, const std::function<std::string(uint32_t)>& output_path,
+                            const std::function<void(uint32_t, bool)>& progress,
+                            std::vector<SlotStats>* stats) const {
+    // Each task times itself into its own entry, the vector is never resized meanwhile
+    std::vector<SlotStats> image_stats(stats ? image_count_ : 0);
+    
+    // Images decode concurrently, results and errors are reported in index
+    // order. Once an image fails, images after it are no longer started;
+    // earlier ones still run so the first failure in index order is the
+    // one reported.
+    struct Result {
+        bool ok;
+        std::string error;
+        
+        Result() : ok(false) {}
+    };
+    std::atomic<size_t> first_failure(image_count_);
+    bool all_ok = true;
+    orderedParallelFor<Result>(pool, image_count_,
+        [&](size_t i) {
+            Result result;
+            if (i > first_failure.load()) {
+                return result;
+            }
+            StatsScope scope(stats ? &image_stats[i].stages : StatsScope::current());
+            result.ok = extractImage(static_cast<uint32_t>(i), output_path(static_cast<uint32_t>(i)),
+                                     result.error);
+            if (!result.ok) {
+                size_t failed = first_failure.load();
+                while (i < failed && !first_failure.compare_exchange_weak(failed, i)) {
+                }
+            }
+            return result;
+        },
+        [&](size_t i, Result& result) {
+            if (!all_ok) {
+                return;
+            }
+            all_ok = result.ok;
+            if (stats) {
+                ImageInfo info = getImageInfo(static_cast<uint32_t>(i));
+                SlotStats& entry = image_stats[i];
+                entry.index = i;
+                entry.file = output_path(static_cast<uint32_t>(i));
+                entry.width = info.width;
+                entry.height = info.height;
+                entry.frame_bytes = info.uncompressed_size;
+                entry.stored_bytes = info.compressed_size;
+                if (!all_ok) {
+                    entry.error = result.error;
+                }
+                stats->push_back(entry);
+            }
+            if (progress) {
+                progress(static_cast<uint32_t>(i), all_ok);
+            }
+            if (!all_ok) {
+                report(result.error);
+            }
+        });
+    
+    return all_ok;
+}
+
+std::vector<ImageCheck> SplashImage::verify(ThreadPool* pool) const {
+    std::vector<ImageCheck> checks(image_count_);
+    
+    // Images follow each other in the data area, load() checked the file bounds
+    for (uint32_t i = 1; i < image_count_; i++) {
+        uint64_t previous_end = static_cast<uint64_t>(metadata_[i - 1].offset) + metadata_[i - 1].compsz;
+        if (metadata_[i].offset < previous_end) {
+            appendFormat(checks[i].error, "offset 0x%x is inside or before image %u", metadata_[i].offset, i - 1);
+        }
+    }
+    
+    orderedParallelFor<ImageCheck>(pool, image_count_,
+        [&](size_t i) -> ImageCheck {
+            ImageCheck check = checks[i];
+            if (!check.error.empty()) {
+                return check;
+            }
+            
+            const bootmod::ByteSpan& compressed = image_data_[i];
+            if (compressed.size < sizeof(gzip_header_t) + sizeof(gzip_footer_t)) {
+                appendFormat(check.error, "%zu bytes is too small for a gzip member", compressed.size);
+                return check;
+            }
+            
+            // compressImage() writes no optional header fields, deflateStream() relies on that
+            gzip_header_t header;
+            gzip_footer_t footer;
+            memcpy(&header, compressed.data, sizeof(header));
+            memcpy(&footer, compressed.data + compressed.size - sizeof(footer), sizeof(footer));
+            if (header.id1 != 0x1f || header.id2 != 0x8b || header.cm != 0x08) {
+                check.error = "not a gzip member";
+                return check;
+            }
+            if (header.flg & 0x1e) {
+                appendFormat(check.error, "unsupported gzip header flags 0x%02x", header.flg);
+                return check;
+            }
+            
+            size_t size = 0;
+            bootmod::ByteSpan stream(compressed.data + sizeof(header),
+                                     compressed.size - sizeof(header) - sizeof(footer));
+            try {
+                size = bootmod::CodecContext::forThread().inflatedSize(stream, bootmod::DeflateFormat::RAW,
+                                                                       &check.crc32);
+            } catch (const std::exception& e) {
+                check.error = std::string("inflate failed: ") + e.what();
+                return check;
+            }
+            check.inflated_size = static_cast<uint32_t>(size);
+            
+            if (check.crc32 != footer.crc32) {
+                appendFormat(check.error, "CRC-32 0x%08x does not match the footer (0x%08x)",
+                             check.crc32, footer.crc32);
+            } else if (check.inflated_size != footer.isize) {
+                appendFormat(check.error, "inflated to %zu bytes, footer says %u", size, footer.isize);
+            } else if (size != metadata_[i].realsz) {
+                appendFormat(check.error, "inflated to %zu bytes, metadata says %u", size, metadata_[i].realsz);
+            }
+            if (!check.error.empty()) {
+                return check;
+            }
+            
+            BmpGeometry geometry = bmpGeometry(static_cast<uint32_t>(i));
+            if (!geometry.valid) {
+                check.warning = "no BMP header";
+                return check;
+            }
+            
+            // Rows are padded to four bytes, the headers take at least 54
+            uint64_t row_size = (static_cast<uint64_t>(geometry.width) * geometry.bpp + 31) / 32 * 4;
+            uint64_t needed = 54 + row_size * geometry.height;
+            if (needed > size) {
+                appendFormat(check.error, "BMP %ux%u at %u-bit needs %llu bytes, image has %zu",
+                             geometry.width, geometry.height, geometry.bpp,
+                             static_cast<unsigned long long>(needed), size);
+            } else if (geometry.width > width_ || geometry.height > height_) {
+                appendFormat(check.warning, "BMP %ux%u is larger than the %ux%u display",
+                             geometry.width, geometry.height, width_, height_);
+            }
+            return check;
+        },
+        [&](size_t i, ImageCheck& check) {
+            checks[i] = std::move(check);
+        });
+    
+    return checks;
+}
+
 bool SplashImage::replaceImage(uint32_t index, const std::string& png_path) {
     if (index >= image_count_) {
-        std::cerr << "Invalid image index: " << index << std::endl;
+        report("Invalid image index: " + std::to_string(index));
         return false;
     }
     
-    // Detect original BMP format (24-bit or 32-bit)
-    std::vector<uint8_t> original_bmp;
+    // Detect original BMP format (24-bit or 32-bit), only its header is inflated
+    std::vector<uint8_t> original_header;
     uint16_t original_bpp = 24;  // Default to 24-bit
     
-    if (decompressImage(index, original_bmp) && original_bmp.size() >= 54) {
-        original_bpp = *reinterpret_cast<uint16_t*>(&original_bmp[28]);
-        std::cout << "  Original format: " << original_bpp << "-bit BMP\n";
+    if (peekImage(index, 54, original_header) && original_header.size() >= 54) {
+        memcpy(&original_bpp, &original_header[28], 2);
     }
     
-    // Load PNG
+    // Load PNG, read and decoded separately so each is timed on its own
+    std::vector<uint8_t> png;
     std::vector<uint8_t> rgba;
     unsigned width, height;
     
-    unsigned error = lodepng::decode(rgba, width, height, png_path);
+    unsigned error;
+    {
+        StageTimer timer(Stage::READ);
+        error = lodepng::load_file(png, png_path);
+        countBytes(png.size(), 0);
+    }
+    if (!error) {
+        StageTimer timer(Stage::PNG_DECODE);
+        error = lodepng::decode(rgba, width, height, png);
+    }
     if (error) {
-        std::cerr << "PNG decoding failed: " << lodepng_error_text(error) << std::endl;
+        report(std::string("PNG decoding failed: ") + lodepng_error_text(error));
         return false;
     }
     
+    StageTimer convert_timer(Stage::CONVERT);
+    
     // Use original BMP format (preserve 32-bit if it was 32-bit)
     uint16_t bpp = original_bpp;
     int bytes_per_pixel = bpp / 8;
@@ -412,11 +928,21 @@ bool SplashImage::replaceImage(uint32_t index, const std::string& png_path) {
         return false;
     }
     
-    // Update image data and metadata
-    image_data_[index] = compressed;
-    metadata_[index].compsz = compressed.size();
+    // Update image data and metadata, the image now owns its bytes
+    replaced_[index].swap(compressed);
+    image_data_[index] = bootmod::ByteSpan(replaced_[index]);
+    metadata_[index].compsz = image_data_[index].size;
     metadata_[index].realsz = bmp_data.size();
     
+    // The new header is known, no need to probe it later
+    std::lock_guard<std::mutex> lock(geometry_mutex_);
+    BmpGeometry& geometry = geometry_[index];
+    geometry.probed = true;
+    geometry.valid = true;
+    geometry.width = width;
+    geometry.height = height;
+    geometry.bpp = bpp;
+    
     return true;
 }
 
@@ -0,0 +1,176 @@
+/**
+ * @file stats.cpp
+ * @brief Stage timer and statistics implementation
+ */
+
+#include "stats.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace bootmod {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Scope and running timer of this thread
+struct ThreadStats {
+    StageStats* stats;
+    int stage;               // Stage of the innermost timer, -1 if none runs
+    Clock::time_point since;
+};
+
+thread_local ThreadStats thread_stats = {nullptr, -1, Clock::time_point()};
+
+// Add the time since the running timer (re)started to its stage
+void charge(ThreadStats& t, Clock::time_point now) {
+    if (t.stats && t.stage >= 0) {
+        uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t.since).count();
+        t.stats->addTime(static_cast<Stage>(t.stage), nanos);
+    }
+}
+
+const char* const STAGE_NAMES[STAGE_COUNT] = {
+    "read", "inflate", "convert", "png_decode", "png_encode", "deflate", "hash", "write"
+};
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    return STAGE_NAMES[static_cast<size_t>(stage)];
+}
+
+// ============================================================================
+// StageStats Implementation
+// ============================================================================
+
+StageStats::StageStats()
+    : bytes_in_(0)
+    , bytes_out_(0) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        nanos_[i] = 0;
+    }
+}
+
+StageStats::StageStats(const StageStats& other)
+    : bytes_in_(other.bytes_in_.load())
+    , bytes_out_(other.bytes_out_.load()) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        nanos_[i] = other.nanos_[i].load();
+    }
+}
+
+StageStats& StageStats::operator=(const StageStats& other) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        nanos_[i] = other.nanos_[i].load();
+    }
+    bytes_in_ = other.bytes_in_.load();
+    bytes_out_ = other.bytes_out_.load();
+    return *this;
+}
+
+void StageStats::addTime(Stage stage, uint64_t nanoseconds) {
+    nanos_[static_cast<size_t>(stage)] += nanoseconds;
+}
+
+void StageStats::addBytes(uint64_t in, uint64_t out) {
+    bytes_in_ += in;
+    bytes_out_ += out;
+}
+
+void StageStats::add(const StageStats& other) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        nanos_[i] += other.nanos_[i].load();
+    }
+    bytes_in_ += other.bytes_in_.load();
+    bytes_out_ += other.bytes_out_.load();
+}
+
+double StageStats::seconds(Stage stage) const {
+    return nanos_[static_cast<size_t>(stage)].load() / 1e9;
+}
+
+double StageStats::totalSeconds() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        total += nanos_[i].load();
+    }
+    return total / 1e9;
+}
+
+// ============================================================================
+// Scopes and Timers
+// ============================================================================
+
+StatsScope::StatsScope(StageStats* stats) {
+    // A timer of the enclosing scope stops while this one is active, e.g.
+    // when a waiting thread helps with a task that has its own scope
+    ThreadStats& t = thread_stats;
+    charge(t, Clock::now());
+    saved_stats_ = t.stats;
+    saved_stage_ = t.stage;
+    t.stats = stats;
+    t.stage = -1;
+}
+
+StatsScope::~StatsScope() {
+    ThreadStats& t = thread_stats;
+    t.stats = saved_stats_;
+    t.stage = saved_stage_;
+    t.since = Clock::now();
+}
+
+StageStats* StatsScope::current() {
+    return thread_stats.stats;
+}
+
+StageTimer::StageTimer(Stage stage)
+    : active_(thread_stats.stats != nullptr)
+    , previous_(-1) {
+    if (!active_) {
+        return;
+    }
+    ThreadStats& t = thread_stats;
+    Clock::time_point now = Clock::now();
+    charge(t, now);
+    previous_ = t.stage;
+    t.stage = static_cast<int>(stage);
+    t.since = now;
+}
+
+StageTimer::~StageTimer() {
+    if (!active_) {
+        return;
+    }
+    ThreadStats& t = thread_stats;
+    Clock::time_point now = Clock::now();
+    charge(t, now);
+    t.stage = previous_;
+    t.since = now;
+}
+
+void countBytes(uint64_t in, uint64_t out) {
+    if (thread_stats.stats) {
+        thread_stats.stats->addBytes(in, out);
+    }
+}
+
+uint64_t peakResidentBytes() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // Bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // Kilobytes
+#endif
+#endif
+}
+
+} // namespace bootmod
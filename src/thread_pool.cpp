@@ -0,0 +1,194 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Work-stealing thread pool implementation
+ */
+
+#include "thread_pool.h"
+#include "stats.h"
+
+namespace bootmod {
+
+namespace {
+
+// Pool and queue of the worker running on this thread, if any
+thread_local ThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+} // namespace
+
+// ============================================================================
+// ThreadPool Implementation
+// ============================================================================
+
+size_t ThreadPool::defaultThreadCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+ThreadPool::ThreadPool(size_t threads)
+    : pending_(0)
+    , stopping_(false) {
+    if (threads == 0) {
+        threads = defaultThreadCount();
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        queues_.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        threads_.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers push onto their own queue, everyone else onto the shared one
+    WorkQueue& queue = (current_pool == this) ? *queues_[current_queue] : injected_;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        pending_++;
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::popOldest(WorkQueue& queue, std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    pending_--;
+    return true;
+}
+
+bool ThreadPool::popTask(size_t home, std::function<void()>& task) {
+    // Oldest first everywhere: orderedParallelFor queues its indices in
+    // order, so low indices finish first and their results stream out
+    // instead of piling up behind index 0
+    bool worker = home < queues_.size();
+    if (worker && popOldest(*queues_[home], task)) {
+        return true;
+    }
+    if (popOldest(injected_, task)) {
+        return true;
+    }
+
+    // Otherwise steal from another worker
+    size_t start = worker ? home : 0;
+    for (size_t i = 1; i <= queues_.size(); i++) {
+        size_t victim = (start + i) % queues_.size();
+        if (victim != home && popOldest(*queues_[victim], task)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    size_t home = (current_pool == this) ? current_queue : queues_.size();
+
+    std::function<void()> task;
+    if (!popTask(home, task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_queue = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+        if (stopping_ && pending_ <= 0) {
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// TaskGroup Implementation
+// ============================================================================
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool_(pool)
+    , outstanding_(0) {
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Errors are reported through wait(), never from the destructor
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    outstanding_++;
+
+    // Timed into the stats of whoever queued it, whichever thread runs it
+    StageStats* stats = StatsScope::current();
+    pool_.submit([this, task, stats]() {
+        try {
+            StatsScope scope(stats);
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--outstanding_ == 0) {
+            done_.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    while (outstanding_ > 0) {
+        if (!pool_.runPendingTask()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait_for(lock, std::chrono::milliseconds(10),
+                           [this]() { return outstanding_ == 0; });
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace bootmod